@@ -1,97 +1,49 @@
 #include "include/glad/glad.h"
 #include <GLFW/glfw3.h>
-#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 
+#include "src/asset_loader.hpp"
+#include "src/gl_extensions.hpp"
 #include "src/light.hpp"
 #include "src/map.hpp"
+#include "src/car_renderer.hpp"
+#include "src/file_watcher.hpp"
+#include "src/mesh_cache.hpp"
 #include "src/player.hpp"
+#include "src/shader.hpp"
 #include "src/skybox.hpp"
-
-
-// Définir la taille de la carte (à ajuster en fonction de vos besoins)
-#define MAP_SIZE 256 // Exemple de taille de la carte
-
-std::string loadShaderSource(const char *filePath) {
-    std::ifstream shaderFile;
-    std::stringstream shaderStream;
-
-    // Ouvrir le fichier
-    shaderFile.open(filePath);
-    if (!shaderFile) {
-        std::cerr << "Erreur : Impossible d'ouvrir le fichier shader : "
-                  << filePath << std::endl;
-        return "";
-    }
-
-    // Lire le fichier dans un flux
-    shaderStream << shaderFile.rdbuf();
-    shaderFile.close();
-
-    return shaderStream.str();
-}
-
-unsigned int compileShader(const char *filePath, GLenum shaderType) {
-    std::string shaderSource = loadShaderSource(filePath);
-    if (shaderSource.empty()) {
-        std::cerr << "Erreur : Shader vide" << std::endl;
-        return 0;
-    }
-
-    const char *shaderCode = shaderSource.c_str();
-    unsigned int shader = glCreateShader(shaderType);
-    glShaderSource(shader, 1, &shaderCode, NULL);
-    glCompileShader(shader);
-
-    // Vérification des erreurs
-    int success;
-    char infoLog[512];
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::cerr << "Erreur de compilation du shader :\n"
-                  << infoLog << std::endl;
-    }
-
-    return shader;
-}
-
-unsigned int createShaderProgram(const char *vertexPath,
-                                 const char *fragmentPath) {
-    unsigned int vertexShader = compileShader(vertexPath, GL_VERTEX_SHADER);
-    unsigned int fragmentShader =
-        compileShader(fragmentPath, GL_FRAGMENT_SHADER);
-
-    if (vertexShader == 0 || fragmentShader == 0) {
-        return 0;
+#include "src/terrain.hpp"
+#include "src/thread_pool.hpp"
+#include "src/virtual_file_system.hpp"
+
+
+// Charger la carte depuis sa version binaire si elle est à jour (projection
+// en mémoire, sans analyse), sinon depuis sa description texte, puis écrire
+// la version binaire pour les lancements suivants
+bool loadMap(Map &map, const std::string &textPath,
+             const std::string &binaryPath) {
+    std::error_code error;
+    auto textTime = std::filesystem::last_write_time(textPath, error);
+    bool hasText = !error;
+    auto binaryTime = std::filesystem::last_write_time(binaryPath, error);
+    bool binaryUpToDate = !error && (!hasText || binaryTime >= textTime);
+
+    if (binaryUpToDate && map.loadFromFile(binaryPath)) {
+        return true;
     }
-
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    // Vérification des erreurs de linkage
-    int success;
-    char infoLog[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cerr << "Erreur de linkage du shader program :\n"
-                  << infoLog << std::endl;
+    if (!hasText || !map.loadFromFile(textPath)) {
+        return false;
     }
-
-    // Nettoyage
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
+    map.saveBinary(binaryPath);
+    return true;
 }
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
@@ -104,7 +56,7 @@ float lastX = 400.0f, lastY = 300.0f; // Dernière position de la souris
 bool firstMouse = true; // Détecter le premier mouvement de la souris
 
 // Fonction pour gérer les entrées clavier
-void processInput(GLFWwindow *window, Player &player) {
+void processInput(GLFWwindow *window, Player &player, Map &map) {
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
@@ -142,7 +94,31 @@ void processInput(GLFWwindow *window, Player &player) {
     // Quitter avec 'Echap'
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
-    player.car.updateCar(deltaTime, pedalAcceleration, steeringWheel);
+    player.car.updateCar(deltaTime, pedalAcceleration, steeringWheel, map);
+
+    // Case et point de la grille sous la voiture
+    const glm::vec3 &carPosition = player.car.position;
+    int tileX = std::clamp(static_cast<int>(carPosition.x), 0,
+                           map.getWidth() - 1);
+    int tileZ = std::clamp(static_cast<int>(carPosition.z), 0,
+                           map.getDepth() - 1);
+
+    // Tracer une route sous la voiture avec 'E'
+    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS &&
+        map.getTerrainAt(tileX, tileZ) != TerrainType::ROAD) {
+        map.setTerrainAt(tileX, tileZ, TerrainType::ROAD);
+    }
+
+    // Creuser des ornières dans la terre avec 'R'
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS &&
+        map.getTerrainAt(tileX, tileZ) == TerrainType::DIRT) {
+        int pointX = static_cast<int>(std::round(
+            std::clamp(carPosition.x, 0.0f, float(map.getWidth()))));
+        int pointZ = static_cast<int>(std::round(
+            std::clamp(carPosition.z, 0.0f, float(map.getDepth()))));
+        map.setGridHeight(pointX, pointZ,
+                          map.getGridHeight(pointX, pointZ) - 0.5f * deltaTime);
+    }
 }
 
 int main() {
@@ -176,76 +152,71 @@ int main() {
     glViewport(0, 0, 800, 600);
 
     std::cout << "GLAD initialized successfully!" << std::endl;
+    loadGLExtensions();
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glEnable(GL_DEPTH_TEST); // Activer le test de profondeur pour afficher
                              // correctement les objets en 3D.
 
+    // Archive des assets (make pack) : modèles, textures et shaders lus dans
+    // un seul fichier projeté ; sans elle, fichiers isolés
+    if (VirtualFileSystem::get().mount(PACK_FILE_DEFAULT_PATH)) {
+        std::cout << "Archive montée : " << PACK_FILE_DEFAULT_PATH << " ("
+                  << VirtualFileSystem::get().getMountedFileCount()
+                  << " fichiers)" << std::endl;
+    }
+
+    // Threads de travail partagés par les tâches de chargement
+    ThreadPool threadPool;
+
+    // Modèles et textures décodés en arrière-plan, envoyés au GPU au début
+    // de chaque image : la première image n'attend pas les chargements
+    AssetLoader assetLoader(threadPool);
+
+    // Modèles partagés : chaque fichier n'est chargé qu'une fois
+    MeshCache meshCache;
+
     // Initialiser le joueur
     PlayerCameraConfig cameraConfig = {45.0f, 800.0f / 600.0f, 0.1f, 100.0f};
     Player player(glm::vec3(10.0f, 0.0f, 10.0f), glm::vec3(0.0f, 2.0f, 0.0f),
-                  cameraConfig);
-
-    // Initialisation de la carte (terrain)
-    Map map;
-
-    // Nouveau tableau de sommets pour le terrain
-    // Nouveau tableau de sommets avec la couleur associée
-    std::vector<float> terrainVertices;
-    std::vector<unsigned int> terrainIndices;
-
-    for (int x = 0; x < MAP_SIZE - 1; x++) {
-        for (int z = 0; z < MAP_SIZE - 1; z++) {
-            // Position du terrain
-            float xPos = static_cast<float>(x);
-            float zPos = static_cast<float>(z);
-            const float yPos = 0.0f;
-
-            // Déterminer le type de terrain à cette position
-            TerrainType terrainType = map.getTerrainAt(x, z);
-            glm::vec3 color = map.getTerrainColor(terrainType);
-
-            // Normale pointant vers le haut
-            glm::vec3 normal(0.0f, 1.0f, 0.0f);
-
-            // Ajouter les sommets pour un carré (deux triangles)
-            auto addVertex = [&](float x, float y, float z) {
-                terrainVertices.push_back(x);
-                terrainVertices.push_back(y);
-                terrainVertices.push_back(z);
-                terrainVertices.push_back(color.r);
-                terrainVertices.push_back(color.g);
-                terrainVertices.push_back(color.b);
-                terrainVertices.push_back(normal.x);
-                terrainVertices.push_back(normal.y);
-                terrainVertices.push_back(normal.z);
-            };
-
-            addVertex(xPos, yPos, zPos);
-            addVertex(xPos + 1.0f, yPos, zPos);
-            addVertex(xPos + 1.0f, yPos, zPos + 1.0f);
-            addVertex(xPos, yPos, zPos + 1.0f);
-
-            // Ajouter les indices pour les triangles
-            int topLeft = x * MAP_SIZE + z;
-            int topRight = (x + 1) * MAP_SIZE + z;
-            int bottomRight = (x + 1) * MAP_SIZE + (z + 1);
-            int bottomLeft = x * MAP_SIZE + (z + 1);
-
-            terrainIndices.push_back(topLeft);
-            terrainIndices.push_back(topRight);
-            terrainIndices.push_back(bottomRight);
-            terrainIndices.push_back(topLeft);
-            terrainIndices.push_back(bottomRight);
-            terrainIndices.push_back(bottomLeft);
+                  cameraConfig,
+                  meshCache.load("./models/Car2.obj", assetLoader));
+
+    // Initialisation de la carte (terrain) : dimensions et relief lus dans
+    // le fichier de carte, sinon une carte de 256 x 256 avec des collines
+    Map map(256, 256);
+    if (!loadMap(map, "maps/default.map", "maps/default.bmap")) {
+        map = Map(256, 256);
+        map.generateHeights(1337, 8.0f);
+    }
+
+    // Voitures adverses, garées en grille sur le relief, chacune de sa
+    // teinte
+    std::vector<Car> opponents;
+    std::vector<glm::vec3> opponentTints;
+    for (int i = 0; i < OPPONENT_GRID_SIZE; i++) {
+        for (int j = 0; j < OPPONENT_GRID_SIZE; j++) {
+            Car opponent(meshCache.load("./models/Car2.obj", assetLoader));
+            opponent.position =
+                glm::vec3(40.0f + i * OPPONENT_SPACING, 0.0f,
+                          40.0f + j * OPPONENT_SPACING);
+            opponent.angle = 0.7f * (i + j);
+            opponent.updateCar(0.0f, 0, 0, map);
+            opponents.push_back(opponent);
+            opponentTints.push_back(glm::vec3(0.5f + 0.5f * ((i * 7) % 5) / 4.0f,
+                                              0.5f + 0.5f * ((j * 3) % 4) / 3.0f,
+                                              0.5f + 0.5f * ((i + j) % 3) / 2.0f));
         }
     }
 
+    // Terrain découpé en morceaux, chacun testé contre le frustum
+    Terrain terrain(map, threadPool);
+
     // =========================
     // Ajout d'un cube pour le test
     // =========================
     float cubeX = 12.0f;
-    float cubeY = 1.0f;
     float cubeZ = 12.0f;
+    float cubeY = map.getHeightAt(cubeX, cubeZ) + 1.0f;
     float cubeSize = 1.0f;
     glm::vec3 cubeColor(1.0f, 0.0f, 0.0f); // Rouge
     std::vector<float> cubeVertices;
@@ -314,32 +285,24 @@ int main() {
         20, 21, 22, 20, 22, 23  // Face du dessous
     };
 
-    // Ajouter le cube aux tableaux du terrain
-    int terrainVertexCount = terrainVertices.size() / 9;
-    for (unsigned int i = 0; i < cubeIndices.size(); i++) {
-        terrainIndices.push_back(terrainVertexCount + cubeIndices[i]);
-    }
-    terrainVertices.insert(terrainVertices.end(), cubeVertices.begin(),
-                           cubeVertices.end());
-
-    // Création du VAO, VBO et EBO
-    unsigned int terrainVAO, terrainVBO, terrainEBO;
-    glGenVertexArrays(1, &terrainVAO);
-    glGenBuffers(1, &terrainVBO);
-    glGenBuffers(1, &terrainEBO);
+    // Création du VAO, VBO et EBO du cube
+    unsigned int cubeVAO, cubeVBO, cubeEBO;
+    glGenVertexArrays(1, &cubeVAO);
+    glGenBuffers(1, &cubeVBO);
+    glGenBuffers(1, &cubeEBO);
 
-    glBindVertexArray(terrainVAO);
+    glBindVertexArray(cubeVAO);
 
     // VBO : Envoi des sommets
-    glBindBuffer(GL_ARRAY_BUFFER, terrainVBO);
-    glBufferData(GL_ARRAY_BUFFER, terrainVertices.size() * sizeof(float),
-                 terrainVertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+    glBufferData(GL_ARRAY_BUFFER, cubeVertices.size() * sizeof(float),
+                 cubeVertices.data(), GL_STATIC_DRAW);
 
     // EBO : Envoi des indices
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, terrainEBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 terrainIndices.size() * sizeof(unsigned int),
-                 terrainIndices.data(), GL_STATIC_DRAW);
+                 cubeIndices.size() * sizeof(unsigned int),
+                 cubeIndices.data(), GL_STATIC_DRAW);
 
     // Attributs du sommet (Position)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float),
@@ -358,32 +321,46 @@ int main() {
 
     glBindVertexArray(0);
 
-    // Créer le programme shader
-    unsigned int terrainShaderProgram =
-        createShaderProgram("shaders/terrain.vs", "shaders/terrain.fs");
-
-    // Obtenir les locations des uniformes
-    int viewLoc = glGetUniformLocation(terrainShaderProgram, "view");
-    int projectionLoc =
-        glGetUniformLocation(terrainShaderProgram, "projection");
-    // Obtenir la location de l'uniforme 'model'
-    int modelLoc = glGetUniformLocation(terrainShaderProgram, "model");
-    int lightDirLoc = glGetUniformLocation(terrainShaderProgram, "lightDir");
-    int terrainShadowMapLoc =
-        glGetUniformLocation(terrainShaderProgram, "shadowMap");
-    int lightPosLoc = glGetUniformLocation(terrainShaderProgram, "lightPos");
-    int lightSpaceMatrixTerrainLoc = glGetUniformLocation(terrainShaderProgram, "lightSpaceMatrix");
     // Définir la matrice de modèle (ici une matrice identité, mais tu peux y
     // appliquer des transformations)
     glm::mat4 model = glm::mat4(1.0f); // Matrice identité
 
-    glUseProgram(terrainShaderProgram);
-    // Envoi de la matrice 'model' au shader
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUseProgram(0);
-
-    unsigned int carShaderProgram =
-        createShaderProgram("shaders/car.vs", "shaders/car.fs");
+    // Créer le programme shader
+    ShaderProgram terrainShader("shaders/terrain.vs", "shaders/terrain.fs");
+
+    // Obtenir les uniformes, valables après chaque rechargement du
+    // programme
+    const UniformHandle viewLoc = terrainShader.uniform("view");
+    const UniformHandle projectionLoc = terrainShader.uniform("projection");
+    const UniformHandle modelLoc = terrainShader.uniform("model");
+    const UniformHandle lightDirLoc = terrainShader.uniform("lightDir");
+    const UniformHandle terrainShadowMapLoc = terrainShader.uniform("shadowMap");
+    const UniformHandle lightPosLoc = terrainShader.uniform("lightPos");
+    const UniformHandle lightSpaceMatrixTerrainLoc =
+        terrainShader.uniform("lightSpaceMatrix");
+    const UniformHandle compactVerticesLoc =
+        terrainShader.uniform("compactVertices");
+    const UniformHandle packedVerticesLoc =
+        terrainShader.uniform("packedVertices");
+    const UniformHandle splattingLoc = terrainShader.uniform("splatting");
+    terrainShader.setLinkCallback([&](ShaderProgram &program) {
+        glUseProgram(program.getId());
+        // Envoi de la matrice 'model' au shader
+        program.set(modelLoc, model);
+        glUseProgram(0);
+        terrain.sendToShader(program);
+    });
+
+    ShaderProgram carShader("shaders/car.vs", "shaders/car.fs");
+    const UniformHandle carLightSpaceMatrixLoc =
+        carShader.uniform("lightSpaceMatrix");
+    const UniformHandle carLightPosLoc = carShader.uniform("lightPos");
+    const UniformHandle carLightDirLoc = carShader.uniform("lightDir");
+    const UniformHandle carShadowMapLoc = carShader.uniform("shadowMap");
+    const UniformHandle carSkyboxLoc = carShader.uniform("skybox");
+    const UniformHandle carViewPosLoc = carShader.uniform("viewPos");
+    const UniformHandle carViewLoc = carShader.uniform("view");
+    const UniformHandle carProjectionLoc = carShader.uniform("projection");
 
     Light light(SPOT, glm::vec3(8.0f, 10.0f, 8.0f),
                 glm::vec3(0.25f, -1.0f, 0.25f));
@@ -393,14 +370,21 @@ int main() {
     glClear(GL_DEPTH_BUFFER_BIT);
 
     // Activer un shader spécial pour le rendu des ombres
-    unsigned int shadowShader =
-        createShaderProgram("shaders/shadow.vs", "shaders/shadow.fs");
-    glUseProgram(shadowShader);
+    ShaderProgram shadowShader("shaders/shadow.vs", "shaders/shadow.fs");
 
     // Envoyer la transformation de la lumière
-    int lightSpaceMatrixLoc =
-        glGetUniformLocation(shadowShader, "lightSpaceMatrix");
-    int shadowModelLoc = glGetUniformLocation(shadowShader, "model");
+    const UniformHandle lightSpaceMatrixLoc =
+        shadowShader.uniform("lightSpaceMatrix");
+    const UniformHandle shadowModelLoc = shadowShader.uniform("model");
+    const UniformHandle shadowPackedVerticesLoc =
+        shadowShader.uniform("packedVertices");
+
+    // Voitures : toutes dessinées d'un appel par sous-mesh, avec des
+    // shaders qui lisent la matrice modèle dans les attributs d'instance
+    CarRenderer carRenderer;
+    ShaderProgram carShadowShader("shaders/car_shadow.vs", "shaders/shadow.fs");
+    const UniformHandle carShadowLightSpaceMatrixLoc =
+        carShadowShader.uniform("lightSpaceMatrix");
 
     std::vector<std::string> faces = {
         "assets/skybox/right.jpg",
@@ -410,14 +394,45 @@ int main() {
         "assets/skybox/front.jpg",
         "assets/skybox/back.jpg"
     };
-    Skybox skybox(faces);
+    Skybox skybox(faces, assetLoader);
 
-    int skyboxShader = createShaderProgram("shaders/skybox.vs", "shaders/skybox.fs");
+    ShaderProgram skyboxShader("shaders/skybox.vs", "shaders/skybox.fs");
 
+    // Rechargement à chaud : les shaders, modèles et textures modifiés sur
+    // le disque sont relus sans redémarrer
+    ShaderProgram *shaders[] = {&terrainShader, &carShader, &shadowShader,
+                                &carShadowShader, &skyboxShader};
+    FileWatcher fileWatcher;
+    for (const char *directory : {"shaders", "models", "assets/skybox"}) {
+        fileWatcher.watchDirectory(directory);
+    }
 
     // Boucle de rendu
     while (!glfwWindowShouldClose(window)) {
-        processInput(window, player);
+        processInput(window, player, map);
+
+        // Fichiers modifiés : relus en arrière-plan, remplacés à l'envoi
+        for (const std::string &path : fileWatcher.poll()) {
+            for (ShaderProgram *shader : shaders) {
+                if (shader->usesFile(path)) {
+                    shader->reload(assetLoader);
+                }
+            }
+            const std::string extension =
+                std::filesystem::path(path).extension().string();
+            if (extension == ".obj" || extension == ".mtl") {
+                meshCache.reload(path, assetLoader);
+            }
+            if (skybox.usesFile(path)) {
+                skybox.reload(assetLoader);
+            }
+        }
+
+        // Envoyer au GPU les modèles, les textures et les shaders décodés
+        assetLoader.processUploads();
+
+        // Renvoyer au GPU les morceaux et les cases de terrain modifiés
+        terrain.uploadChanges(map);
 
         glClearColor(0.f, 0.f, 0.f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -425,61 +440,98 @@ int main() {
         // Mettre à jour la caméra
         player.updateCamera();
 
+        // Niveau de détail de chaque morceau de terrain selon la caméra
+        terrain.update(player.getViewPos(),
+                       glm::radians(player.getCameraConfig().fov), HEIGHT);
+        // Voitures de l'image, chacune au niveau de détail de sa taille à
+        // l'écran
+        carRenderer.clear();
+        player.car.updateLod(player.getViewPos(), player.getProjectionMatrix(),
+                             HEIGHT);
+        carRenderer.add(player.car);
+        for (size_t i = 0; i < opponents.size(); i++) {
+            opponents[i].updateLod(player.getViewPos(),
+                                   player.getProjectionMatrix(), HEIGHT);
+            carRenderer.add(opponents[i], opponentTints[i]);
+        }
+
         // 1. Rendu dans la shadow map
         glViewport(0, 0, 2048, 2048); // Vue de la shadow map
         glBindFramebuffer(GL_FRAMEBUFFER, light.shadowMapFBO);
 
-        glUseProgram(shadowShader);
+        glUseProgram(shadowShader.getId());
         glClear(GL_DEPTH_BUFFER_BIT);
         // Envoi de la transformation de la lumière dans le shader
-        glUniformMatrix4fv(lightSpaceMatrixLoc, 1, GL_FALSE,
-                           glm::value_ptr(light.lightSpaceMatrix));
-
-        // Dessiner les objets pour générer la shadow map
-        player.renderForShadowMap(shadowShader, shadowModelLoc);
-
-        // Dessiner le terrain pour la shadow map
-        glUniformMatrix4fv(shadowModelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glBindVertexArray(terrainVAO);
-        glDrawElements(GL_TRIANGLES, terrainIndices.size(), GL_UNSIGNED_INT, 0);
+        shadowShader.set(lightSpaceMatrixLoc, light.lightSpaceMatrix);
+
+        // Dessiner le terrain pour la shadow map (seulement les morceaux vus
+        // par la lumière)
+        shadowShader.set(shadowModelLoc, model);
+        terrain.bindVertexFormat(shadowShader);
+        terrain.render(Frustum(light.lightSpaceMatrix));
+        shadowShader.set(shadowPackedVerticesLoc, GL_FALSE);
+        glBindVertexArray(cubeVAO);
+        glDrawElements(GL_TRIANGLES, cubeIndices.size(), GL_UNSIGNED_INT, 0);
+
+        // Dessiner les voitures vues par la lumière
+        glUseProgram(carShadowShader.getId());
+        carShadowShader.set(carShadowLightSpaceMatrixLoc,
+                            light.lightSpaceMatrix);
+        carRenderer.renderForShadowMap(carShadowShader,
+                                       Frustum(light.lightSpaceMatrix));
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0); // Dé-finir le framebuffer
         glViewport(0, 0, 800, 600); // Retourner à la taille de la fenêtre
         
 
         // Afficher le terrain
-        glUseProgram(terrainShaderProgram);
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE,
-                           glm::value_ptr(player.getViewMatrix()));
-        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE,
-                           glm::value_ptr(player.getProjectionMatrix()));
-        glUniformMatrix4fv(lightSpaceMatrixTerrainLoc, 1, GL_FALSE, glm::value_ptr(light.lightSpaceMatrix));
-        glUniform3fv(lightPosLoc, 1, glm::value_ptr(light.position));
-        glUniform3fv(lightDirLoc, 1, glm::value_ptr(light.direction));
-        glBindVertexArray(terrainVAO);
+        glUseProgram(terrainShader.getId());
+        terrainShader.set(modelLoc, model);
+
+        terrainShader.set(viewLoc, player.getViewMatrix());
+        terrainShader.set(projectionLoc, player.getProjectionMatrix());
+        terrainShader.set(lightSpaceMatrixTerrainLoc, light.lightSpaceMatrix);
+        terrainShader.set(lightPosLoc, light.position);
+        terrainShader.set(lightDirLoc, light.direction);
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, light.shadowMapTexture);
-        glUniform1i(terrainShadowMapLoc, 1);
+        terrainShader.set(terrainShadowMapLoc, 1);
         glActiveTexture(0);
 
-        glDrawElements(GL_TRIANGLES, terrainIndices.size(), GL_UNSIGNED_INT, 0);
+        // Seuls les morceaux dans le champ de la caméra sont dessinés
+        terrain.bindVertexFormat(terrainShader);
+        terrainShader.set(splattingLoc, GL_TRUE);
+        terrain.render(Frustum(player.getProjectionMatrix() *
+                               player.getViewMatrix()));
+
+        // Le cube garde des sommets complets (couleur et normale)
+        terrainShader.set(compactVerticesLoc, GL_FALSE);
+        terrainShader.set(packedVerticesLoc, GL_FALSE);
+        terrainShader.set(splattingLoc, GL_FALSE);
+        glBindVertexArray(cubeVAO);
+        glDrawElements(GL_TRIANGLES, cubeIndices.size(), GL_UNSIGNED_INT, 0);
         glUseProgram(0);
         
-        glUseProgram(carShaderProgram);
+        glUseProgram(carShader.getId());
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, light.shadowMapTexture);
-        glUniformMatrix4fv(glGetUniformLocation(carShaderProgram, "lightSpaceMatrix"), 1, GL_FALSE, glm::value_ptr(light.lightSpaceMatrix));
-        glUniform3fv(glGetUniformLocation(carShaderProgram, "lightPos"), 1, glm::value_ptr(light.position));
-        glUniform3fv(glGetUniformLocation(carShaderProgram, "lightDir"), 1, glm::value_ptr(light.direction));
-        glUniform1i(glGetUniformLocation(carShaderProgram, "shadowMap"), light.shadowMapTexture);
+        carShader.set(carLightSpaceMatrixLoc, light.lightSpaceMatrix);
+        carShader.set(carLightPosLoc, light.position);
+        carShader.set(carLightDirLoc, light.direction);
+        carShader.set(carShadowMapLoc,
+                      static_cast<int>(light.shadowMapTexture));
         glActiveTexture(GL_TEXTURE2);
         glBindTexture(GL_TEXTURE_CUBE_MAP, skybox.getCumbeMapTexture());
-        glUniform1i(glGetUniformLocation(carShaderProgram, "skybox"), 2);
-        glUniform3fv(glGetUniformLocation(carShaderProgram, "viewPos"), 1, glm::value_ptr(player.getViewPos()));
-
-        player.render(carShaderProgram);
+        carShader.set(carSkyboxLoc, 2);
+        carShader.set(carViewPosLoc, player.getViewPos());
+        carShader.set(carViewLoc, player.getViewMatrix());
+        carShader.set(carProjectionLoc, player.getProjectionMatrix());
+
+        // Seules les voitures dans le champ de la caméra sont dessinées
+        carRenderer.render(carShader,
+                           Frustum(player.getProjectionMatrix() *
+                                   player.getViewMatrix()));
+        glUseProgram(0);
         glActiveTexture(0);
         skybox.render(skyboxShader, glm::mat4(glm::mat3(player.getViewMatrix())), player.getProjectionMatrix());
 
@@ -3,23 +3,47 @@
 layout (location = 0) in vec3 aPos;  // Position du vertex
 layout (location = 1) in vec3 aColor; // Couleur du vertex
 layout (location = 2) in vec3 aNorm;
+layout (location = 3) in uint aMaterial; // Indice du matériau (sommets compressés)
+layout (location = 4) in mat4 aModel;    // Matrice modèle de l'instance (4 à 7)
+layout (location = 8) in vec3 aTint;     // Teinte de l'instance
 
 out vec3 fragColor; // Variable de sortie pour la couleur
 out vec3 fragNorm;
 out vec4 FragPosLightSpace;
 out vec3 fragPos;
 
-uniform mat4 model;     // Matrice modèle
 uniform mat4 view;      // Matrice de vue
 uniform mat4 projection; // Matrice de projection
 uniform mat4 lightSpaceMatrix;
+uniform bool packedVertices;     // Sommets compressés (voir mesh_file.hpp)
+uniform vec3 positionScale;      // Position = aPos * positionScale + positionOffset
+uniform vec3 positionOffset;
+uniform vec3 materialColors[16]; // Couleur de chaque matériau
+
+// Normale octaédrique. Le même codage apparaît à trois endroits, à modifier
+// ensemble : packOctahedralNormal (src/vertex_packing.hpp, encodage) et
+// octDecode dans shaders/car.vs et shaders/terrain.vs.
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
 
 void main()
 {
-    // Appliquer les transformations
-    fragNorm = normalize(mat3(transpose(inverse(model))) * aNorm);
-    fragPos = vec3(model * vec4(aPos, 1.0));
-    FragPosLightSpace = lightSpaceMatrix * model * vec4(aPos, 1.0f);
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
-    fragColor = aColor; // Passer la couleur au fragment shader
+    vec3 position = packedVertices ? aPos * positionScale + positionOffset : aPos;
+    vec3 normal = packedVertices ? octDecode(aNorm.xy) : aNorm;
+
+    // Appliquer les transformations (la matrice modèle n'a ni échelle ni
+    // cisaillement : elle transforme directement les normales)
+    vec4 worldPos = aModel * vec4(position, 1.0);
+    fragNorm = normalize(mat3(aModel) * normal);
+    fragPos = vec3(worldPos);
+    FragPosLightSpace = lightSpaceMatrix * worldPos;
+    gl_Position = projection * view * worldPos;
+    // Passer la couleur teintée au fragment shader
+    fragColor = (packedVertices ? materialColors[aMaterial] : aColor) * aTint;
 }
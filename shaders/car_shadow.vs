@@ -0,0 +1,16 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;   // Position du sommet
+layout (location = 4) in mat4 aModel; // Matrice modèle de l'instance (4 à 7)
+
+uniform mat4 lightSpaceMatrix; // Matrice de transformation de la lumière
+uniform bool packedVertices;   // Position quantifiée sur 16 bits
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+
+void main()
+{
+    vec3 position = packedVertices ? aPos * positionScale + positionOffset : aPos;
+    // Transformer la position du sommet dans l'espace de la lumière
+    gl_Position = lightSpaceMatrix * aModel * vec4(position, 1.0);
+}
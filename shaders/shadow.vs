@@ -4,9 +4,13 @@ layout (location = 0) in vec3 aPos; // Position du sommet
 
 uniform mat4 model;     // Matrice modèle
 uniform mat4 lightSpaceMatrix; // Matrice de transformation de la lumière
+uniform bool packedVertices;   // Position quantifiée sur 16 bits
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
 
 void main()
 {
+    vec3 position = packedVertices ? aPos * positionScale + positionOffset : aPos;
     // Transformer la position du sommet dans l'espace de la lumière
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = lightSpaceMatrix * model * vec4(position, 1.0);
 }
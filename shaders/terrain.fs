@@ -2,7 +2,7 @@
 
 out vec4 FragColor;
 
-in vec3 fragColor;
+in vec3 vertexColor;
 in vec4 FragPosLightSpace;
 in vec3 Normal;
 in vec3 FragPos;
@@ -10,17 +10,49 @@ in vec3 FragPos;
 uniform sampler2D shadowMap;
 uniform vec3 lightDir;
 uniform vec3 lightPos;
+uniform bool compactVertices; // Pas de normale dans les sommets compacts
+uniform bool splatting;       // Couleur lue dans les textures du terrain
+uniform usampler2D tileTypes;           // Type de chaque case (un texel par case)
+uniform sampler2DArray terrainMaterials; // Une couche par type de case
+
+// Nombre de cases couvertes par une répétition d'une couche de matériau
+const float MATERIAL_TILING = 4.0;
+
+// Couleur du matériau de la case tile au point uv
+vec3 tileMaterial(ivec2 tile, vec2 uv)
+{
+    tile = clamp(tile, ivec2(0), textureSize(tileTypes, 0) - 1);
+    uint type = texelFetch(tileTypes, tile, 0).r;
+    return texture(terrainMaterials, vec3(uv, float(type))).rgb;
+}
+
+// Mélange des matériaux des quatre cases les plus proches, pondérés selon
+// la distance à leur centre : les frontières entre types sont adoucies sur
+// une faible largeur
+vec3 splatColor(vec2 position)
+{
+    vec2 uv = position / MATERIAL_TILING;
+    vec2 cell = position - 0.5;
+    ivec2 tile = ivec2(floor(cell));
+    vec2 weight = smoothstep(0.35, 0.65, fract(cell));
+    vec3 top = mix(tileMaterial(tile, uv), tileMaterial(tile + ivec2(1, 0), uv), weight.x);
+    vec3 bottom = mix(tileMaterial(tile + ivec2(0, 1), uv), tileMaterial(tile + ivec2(1, 1), uv), weight.x);
+    return mix(top, bottom, weight.y);
+}
 
 void main()
 {
-    // Normaliser la normale et la direction de la lumière
-    vec3 norm = normalize(Normal);
+    // Normaliser la normale et la direction de la lumière. Sans normale dans
+    // les sommets, on prend celle de la facette (dérivées de la position).
+    vec3 faceNormal = normalize(cross(dFdx(FragPos), dFdy(FragPos)));
+    vec3 norm = compactVertices ? faceNormal : normalize(Normal);
     vec3 lightDirection = normalize(-lightDir);
 
     // Éclairage de base (Lambert)
     float diff = max(dot(norm, lightDirection), 0.0);
     vec3 lightColor = vec3(1.0, 1.0, 1.0);
-    vec3 lighting = diff * lightColor * fragColor;
+    vec3 surfaceColor = splatting ? splatColor(FragPos.xz) : vertexColor;
+    vec3 lighting = diff * lightColor * surfaceColor;
 
     // Convertir FragPosLightSpace en coordonnées de texture
     vec3 projCoords = FragPosLightSpace.xyz / FragPosLightSpace.w;
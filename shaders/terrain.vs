@@ -1,10 +1,10 @@
 #version 330 core
 
 layout (location = 0) in vec3 aPosition;  // Position du sommet
-layout (location = 1) in vec3 aColor;     // Couleur du sommet
+layout (location = 1) in vec3 aColor;     // Couleur du sommet (hors terrain)
 layout (location = 2) in vec3 aNormal;    // Normale du sommet
 
-out vec3 fragColor;  
+out vec3 vertexColor;
 out vec4 FragPosLightSpace;
 out vec3 Normal;
 out vec3 FragPos;
@@ -13,20 +13,40 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 lightSpaceMatrix;
+uniform bool compactVertices;    // Sommets sans normale
+uniform bool packedVertices;     // Position sur 16 bits, normale octaédrique
+uniform vec3 positionScale;      // Position = aPosition * positionScale + positionOffset
+uniform vec3 positionOffset;
+uniform bool splatting;          // Couleur lue dans les textures du terrain
+
+// Normale octaédrique. Le même codage apparaît à trois endroits, à modifier
+// ensemble : packOctahedralNormal (src/vertex_packing.hpp, encodage) et
+// octDecode dans shaders/car.vs et shaders/terrain.vs.
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
 
 void main()
 {
-    fragColor = aColor;
+    vertexColor = splatting ? vec3(1.0) : aColor;
+    vec3 position = packedVertices ? aPosition * positionScale + positionOffset : aPosition;
+    vec3 normal = compactVertices ? vec3(0.0, 1.0, 0.0) // Remplacée dans le fragment shader
+                : packedVertices ? octDecode(aNormal.xy) : aNormal;
 
     // Position du fragment dans l'espace monde
-    FragPos = vec3(model * vec4(aPosition, 1.0));
+    FragPos = vec3(model * vec4(position, 1.0));
     
     // Transformer la position vers l'espace lumière
     FragPosLightSpace = lightSpaceMatrix * model * vec4(FragPos, 1.0);
 
     // Transformer la normale correctement
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(model))) * normal;
 
     // Calculer la position finale
-    gl_Position = projection * view * model * vec4(aPosition, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
 }
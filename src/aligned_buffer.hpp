@@ -0,0 +1,66 @@
+#ifndef ALIGNED_BUFFER_H
+#define ALIGNED_BUFFER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// Tableau de taille fixe alloué sur le tas et aligné sur une ligne de cache
+// (64 octets), pour les grandes tables parcourues à chaque image. Les
+// éléments ne sont pas initialisés.
+template <typename T> class AlignedBuffer {
+  public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    AlignedBuffer() : elements(nullptr), count(0) {}
+
+    explicit AlignedBuffer(size_t count) : elements(nullptr), count(count) {
+        if (count == 0) {
+            return;
+        }
+        // aligned_alloc exige une taille multiple de l'alignement
+        size_t bytes = (count * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT *
+                       ALIGNMENT;
+        elements = static_cast<T *>(std::aligned_alloc(ALIGNMENT, bytes));
+        if (!elements) {
+            throw std::bad_alloc();
+        }
+    }
+
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+    AlignedBuffer(AlignedBuffer &&other) noexcept
+        : elements(other.elements), count(other.count) {
+        other.elements = nullptr;
+        other.count = 0;
+    }
+
+    AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+        std::swap(elements, other.elements);
+        std::swap(count, other.count);
+        return *this;
+    }
+
+    ~AlignedBuffer() { std::free(elements); }
+
+    void fill(const T &value) {
+        for (size_t i = 0; i < count; i++) {
+            elements[i] = value;
+        }
+    }
+
+    T *data() { return elements; }
+    const T *data() const { return elements; }
+    size_t size() const { return count; }
+
+    T &operator[](size_t i) { return elements[i]; }
+    const T &operator[](size_t i) const { return elements[i]; }
+
+  private:
+    T *elements;
+    size_t count;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "asset_loader.hpp"
+
+#include <iostream>
+#include <utility>
+
+AssetLoader::AssetLoader(ThreadPool &pool)
+    : pool(pool), decoding(0), pending(0), loaded(0),
+      loadStart(std::chrono::steady_clock::now()) {}
+
+AssetLoader::~AssetLoader() {
+    // Les tâches en cours écrivent encore dans uploads
+    std::unique_lock<std::mutex> lock(mutex);
+    decodedCondition.wait(lock, [this] { return decoding == 0; });
+}
+
+void AssetLoader::load(std::function<UploadStep()> decode) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending == 0) {
+            loadStart = std::chrono::steady_clock::now();
+        }
+        decoding++;
+        pending++;
+    }
+    pool.submit([this, decode = std::move(decode)] {
+        UploadStep upload = decode();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (upload) {
+            uploads.push_back(std::move(upload));
+        } else {
+            pending--; // Échec : rien à envoyer
+        }
+        decoding--;
+        decodedCondition.notify_all();
+    });
+}
+
+int AssetLoader::processUploads() {
+    std::vector<UploadStep> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (uploads.empty()) {
+            return 0;
+        }
+        ready.swap(uploads);
+    }
+
+    // Les envois se font hors du verrou : les décodages continuent
+    for (UploadStep &upload : ready) {
+        upload();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending -= static_cast<int>(ready.size());
+    loaded += static_cast<int>(ready.size());
+    if (pending == 0) {
+        const double milliseconds =
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - loadStart)
+                .count();
+        std::cout << "Assets chargés : " << loaded << " en " << milliseconds
+                  << " ms (" << pool.getThreadCount() << " threads)"
+                  << std::endl;
+    }
+    return static_cast<int>(ready.size());
+}
+
+int AssetLoader::getPendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending;
+}
@@ -0,0 +1,58 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+// Chargement des assets en arrière-plan. Chaque asset est décodé (lecture
+// du fichier, décompression, import) sur un thread du ThreadPool ; seul
+// l'envoi au GPU, qui exige le contexte OpenGL, est exécuté sur le thread
+// GL par processUploads(). En attendant, les assets restent des
+// remplaçants (modèle vide, texture d'un texel) : la première image
+// s'affiche sans attendre les chargements.
+class AssetLoader {
+  public:
+    // Étape d'envoi au GPU d'un asset décodé
+    typedef std::function<void()> UploadStep;
+
+    explicit AssetLoader(ThreadPool &pool);
+    // Attendre la fin des décodages en cours ; les envois restants sont
+    // abandonnés
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader &) = delete;
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    // Décoder un asset sur un thread de travail. decode renvoie l'étape
+    // d'envoi au GPU, ou une étape vide si le chargement a échoué.
+    void load(std::function<UploadStep()> decode);
+
+    // Exécuter les envois des assets décodés depuis le dernier appel. À
+    // appeler sur le thread GL, une fois par image. Renvoie le nombre
+    // d'assets envoyés.
+    int processUploads();
+
+    // Nombre d'assets pas encore décodés ou pas encore envoyés
+    int getPendingCount();
+
+    // Threads de décodage, pour découper le décodage d'un asset
+    // (ThreadPool::parallelFor depuis la fonction de décodage)
+    ThreadPool &getThreadPool() { return pool; }
+
+  private:
+    ThreadPool &pool;
+    std::mutex mutex;
+    std::condition_variable decodedCondition;
+    std::vector<UploadStep> uploads; // Décodés, en attente d'envoi
+    int decoding;                    // Décodages en cours
+    int pending;                     // Assets pas encore envoyés
+    int loaded;                      // Assets envoyés depuis le début
+    std::chrono::steady_clock::time_point loadStart;
+};
+
+#endif
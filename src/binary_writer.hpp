@@ -0,0 +1,26 @@
+#ifndef BINARY_WRITER_H
+#define BINARY_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Écriture des fichiers binaires précalculés : chaque tableau commence sur
+// une frontière d'alignement, pour être projeté en mémoire et lu en place
+
+// offset arrondi au multiple de alignment suivant
+inline uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Écrire bytes octets à la position offset de file, après avoir complété
+// avec des zéros depuis la position courante (qui ne doit pas la dépasser)
+inline void writeAt(std::ostream &file, uint64_t offset, const void *data,
+                    size_t bytes) {
+    std::vector<char> padding(offset - static_cast<uint64_t>(file.tellp()), 0);
+    file.write(padding.data(), padding.size());
+    file.write(static_cast<const char *>(data), bytes);
+}
+
+#endif
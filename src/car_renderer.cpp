@@ -0,0 +1,136 @@
+#include "car_renderer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+CarRenderer::CarRenderer() : instanceBuffer(0), instanceCapacity(0) {
+    glGenBuffers(1, &instanceBuffer);
+}
+
+CarRenderer::~CarRenderer() { glDeleteBuffers(1, &instanceBuffer); }
+
+void CarRenderer::add(const Car &car, const glm::vec3 &tint) {
+    const Mesh *mesh = car.getMesh();
+    if (!mesh || mesh->getLodCount() == 0) {
+        return;
+    }
+    CarInstance instance;
+    instance.mesh = mesh;
+    instance.lod = car.getLod();
+    instance.model = car.getModelMatrix();
+    instance.tint = tint;
+
+    // Boîte du modèle transformée : centre déplacé, demi-côtés projetés sur
+    // les axes du monde
+    const glm::vec3 center = (mesh->boundsMin + mesh->boundsMax) * 0.5f;
+    const glm::vec3 extent = (mesh->boundsMax - mesh->boundsMin) * 0.5f;
+    const glm::vec3 worldCenter =
+        glm::vec3(instance.model * glm::vec4(center, 1.0f));
+    glm::vec3 worldExtent(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        worldExtent += glm::abs(glm::vec3(instance.model[axis])) * extent[axis];
+    }
+    instance.bounds.min = worldCenter - worldExtent;
+    instance.bounds.max = worldCenter + worldExtent;
+    cars.push_back(instance);
+}
+
+int CarRenderer::render(ShaderProgram &program, const Frustum &frustum) {
+    return draw(program, frustum, 0);
+}
+
+int CarRenderer::renderForShadowMap(ShaderProgram &program,
+                                    const Frustum &frustum) {
+    // L'ombre tolère un niveau de détail plus simplifié que l'image
+    return draw(program, frustum, 1);
+}
+
+int CarRenderer::draw(ShaderProgram &program, const Frustum &frustum,
+                      int lodBias) {
+    auto lodOf = [lodBias](const CarInstance *car) {
+        return std::min(car->lod + lodBias, car->mesh->getLodCount() - 1);
+    };
+
+    // Voitures visibles, regroupées par modèle puis par niveau de détail
+    visible.clear();
+    for (const CarInstance &car : cars) {
+        if (frustum.intersects(car.bounds)) {
+            visible.push_back(&car);
+        }
+    }
+    if (visible.empty()) {
+        return 0;
+    }
+    std::sort(visible.begin(), visible.end(),
+              [&](const CarInstance *a, const CarInstance *b) {
+                  if (a->mesh != b->mesh) {
+                      return a->mesh < b->mesh;
+                  }
+                  return lodOf(a) < lodOf(b);
+              });
+
+    instances.resize(visible.size());
+    for (size_t i = 0; i < visible.size(); i++) {
+        std::memcpy(instances[i].model, glm::value_ptr(visible[i]->model),
+                    sizeof(instances[i].model));
+        instances[i].tint[0] = visible[i]->tint.x;
+        instances[i].tint[1] = visible[i]->tint.y;
+        instances[i].tint[2] = visible[i]->tint.z;
+        instances[i].tint[3] = 1.0f;
+    }
+
+    // Tampon réalloué (et donc détaché de l'image précédente) à chaque
+    // passe, agrandi si besoin
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    instanceCapacity = std::max(instanceCapacity, instances.size());
+    glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData),
+                 nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData),
+                    instances.data());
+
+    // Un appel par sous-mesh de chaque groupe
+    const Mesh::VertexFormatUniforms &uniforms =
+        vertexFormatUniforms.get(program);
+    for (size_t first = 0; first < visible.size();) {
+        const Mesh *mesh = visible[first]->mesh;
+        const int lod = lodOf(visible[first]);
+        size_t end = first + 1;
+        while (end < visible.size() && visible[end]->mesh == mesh &&
+               lodOf(visible[end]) == lod) {
+            end++;
+        }
+
+        glBindVertexArray(mesh->vao);
+        bindInstanceAttributes(first);
+        mesh->bindVertexFormat(program, uniforms);
+        mesh->drawInstanced(lod, static_cast<int>(end - first));
+        first = end;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return static_cast<int>(visible.size());
+}
+
+void CarRenderer::bindInstanceAttributes(size_t firstInstance) const {
+    // Le tampon d'instances est lié à GL_ARRAY_BUFFER ; les attributs
+    // pointent sur le premier élément du groupe
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = firstInstance * sizeof(InstanceData);
+    for (int column = 0; column < 4; column++) {
+        const unsigned int location = CAR_INSTANCE_ATTRIBUTE + column;
+        glVertexAttribPointer(
+            location, 4, GL_FLOAT, GL_FALSE, stride,
+            (void *)(base + offsetof(InstanceData, model) +
+                     column * 4 * sizeof(float)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    const unsigned int tintLocation = CAR_INSTANCE_ATTRIBUTE + 4;
+    glVertexAttribPointer(tintLocation, 3, GL_FLOAT, GL_FALSE, stride,
+                          (void *)(base + offsetof(InstanceData, tint)));
+    glEnableVertexAttribArray(tintLocation);
+    glVertexAttribDivisor(tintLocation, 1);
+}
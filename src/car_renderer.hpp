@@ -0,0 +1,78 @@
+#ifndef CAR_RENDERER_H
+#define CAR_RENDERER_H
+
+#include "../include/glad/glad.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "car.hpp"
+#include "frustum.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+
+// Premier attribut de sommet des données par instance : matrice modèle
+// (4 colonnes, emplacements 4 à 7) puis teinte (emplacement 8)
+#define CAR_INSTANCE_ATTRIBUTE 4
+
+// Rendu instancié des voitures. Les voitures de l'image sont rassemblées
+// par add() ; chaque passe ne garde que celles qui intersectent son
+// frustum, les regroupe par modèle et par niveau de détail, écrit leurs
+// matrices et leurs teintes dans un tampon d'instances renouvelé à chaque
+// passe et dessine chaque groupe d'un glDrawElementsInstancedBaseVertex par
+// sous-mesh. Le nombre d'appels ne dépend donc plus du nombre de voitures.
+//
+// Les shaders lisent la matrice modèle et la teinte dans les attributs
+// d'instance (voir shaders/car.vs et shaders/car_shadow.vs) ; vue,
+// projection et lumière restent des uniformes fixés par l'appelant.
+class CarRenderer {
+  public:
+    CarRenderer();
+    ~CarRenderer();
+    CarRenderer(const CarRenderer &) = delete;
+    CarRenderer &operator=(const CarRenderer &) = delete;
+
+    // Oublier les voitures de l'image précédente
+    void clear() { cars.clear(); }
+
+    // Ajouter une voiture à l'image, au niveau de détail choisi par
+    // Car::updateLod. La voiture doit vivre jusqu'aux rendus de l'image.
+    void add(const Car &car, const glm::vec3 &tint = glm::vec3(1.0f));
+
+    // Dessiner les voitures visibles (le shader doit déjà être actif).
+    // Renvoie le nombre de voitures dessinées.
+    int render(ShaderProgram &program, const Frustum &frustum);
+
+    // Même chose pour la shadow map, un niveau de détail plus simplifié
+    int renderForShadowMap(ShaderProgram &program, const Frustum &frustum);
+
+    int getCarCount() const { return static_cast<int>(cars.size()); }
+
+  private:
+    struct CarInstance {
+        const Mesh *mesh;
+        int lod;
+        glm::mat4 model;
+        glm::vec3 tint;
+        AABB bounds; // Boîte englobante dans le monde
+    };
+
+    // Données d'une instance, telles que lues par le vertex shader
+    struct InstanceData {
+        float model[16];
+        float tint[4];
+    };
+
+    std::vector<CarInstance> cars;
+    // Voitures visibles de la passe en cours, triées par groupe
+    std::vector<const CarInstance *> visible;
+    std::vector<InstanceData> instances;
+    unsigned int instanceBuffer;
+    size_t instanceCapacity; // En instances
+    // Uniformes des sommets, pour chaque programme de rendu
+    UniformCache<Mesh::VertexFormatUniforms> vertexFormatUniforms;
+
+    int draw(ShaderProgram &program, const Frustum &frustum, int lodBias);
+    void bindInstanceAttributes(size_t firstInstance) const;
+};
+
+#endif
@@ -4,4 +4,9 @@
 #define WIDTH 800
 #define HEIGHT 600
 
+// Voitures adverses garées en grille : OPPONENT_GRID_SIZE x
+// OPPONENT_GRID_SIZE voitures espacées de OPPONENT_SPACING unités
+#define OPPONENT_GRID_SIZE 24
+#define OPPONENT_SPACING 6.0f
+
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "file_watcher.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "virtual_file_system.hpp"
+
+FileWatcher::FileWatcher() : inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+    if (inotifyFd < 0) {
+        std::cerr << "Erreur : inotify indisponible, rechargement à chaud "
+                     "désactivé : "
+                  << std::strerror(errno) << std::endl;
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+}
+
+bool FileWatcher::watchDirectory(const std::string &directory) {
+    if (inotifyFd < 0) {
+        return false;
+    }
+    // Fichier fermé après écriture, ou renommé dans le répertoire
+    int watch = inotify_add_watch(inotifyFd, directory.c_str(),
+                                  IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+        std::cerr << "Erreur : Impossible de surveiller le répertoire : "
+                  << directory << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return false;
+    }
+    directories[watch] = directory;
+    return true;
+}
+
+std::vector<std::string> FileWatcher::poll() {
+    std::vector<std::string> changed;
+    if (inotifyFd < 0) {
+        return changed;
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break; // EAGAIN : plus d'événement en attente
+        }
+        const struct inotify_event *event;
+        for (char *position = buffer; position < buffer + length;
+             position += sizeof(struct inotify_event) + event->len) {
+            event = reinterpret_cast<const struct inotify_event *>(position);
+            auto directory = directories.find(event->wd);
+            if (directory == directories.end() || event->len == 0 ||
+                (event->mask & IN_ISDIR)) {
+                continue;
+            }
+            const std::string path = VirtualFileSystem::normalizePath(
+                directory->second + "/" + event->name);
+            if (std::find(changed.begin(), changed.end(), path) ==
+                changed.end()) {
+                changed.push_back(path);
+            }
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,36 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Surveillance de répertoires par inotify, pour le rechargement à chaud des
+// assets. Ce sont les répertoires qui sont surveillés, pas les fichiers :
+// un éditeur qui enregistre en remplaçant le fichier (écriture d'une copie
+// puis renommage) est suivi comme un autre.
+//
+// Seuls les fichiers isolés sont concernés : un fichier lu dans une
+// archive montée (voir VirtualFileSystem) masque ses modifications.
+class FileWatcher {
+  public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // Surveiller les fichiers du répertoire directory (non récursif)
+    bool watchDirectory(const std::string &directory);
+
+    // Fichiers écrits ou remplacés depuis le dernier appel, chacun une fois,
+    // sous forme normalisée (voir VirtualFileSystem::normalizePath). Ne
+    // bloque pas : à appeler à chaque image.
+    std::vector<std::string> poll();
+
+  private:
+    int inotifyFd; // -1 si inotify est indisponible
+    std::unordered_map<int, std::string> directories; // Par surveillance
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+// Boîte englobante alignée sur les axes (en coordonnées monde)
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+class Frustum {
+  public:
+    // Extraire les six plans à partir d'une matrice projection * vue
+    // (méthode de Gribb/Hartmann). glm stocke les matrices par colonnes :
+    // la ligne i vaut (m[0][i], m[1][i], m[2][i], m[3][i]).
+    explicit Frustum(const glm::mat4 &viewProjection) {
+        glm::vec4 rows[4];
+        for (int i = 0; i < 4; i++) {
+            rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i],
+                                viewProjection[2][i], viewProjection[3][i]);
+        }
+        planes[0] = rows[3] + rows[0]; // Gauche
+        planes[1] = rows[3] - rows[0]; // Droite
+        planes[2] = rows[3] + rows[1]; // Bas
+        planes[3] = rows[3] - rows[1]; // Haut
+        planes[4] = rows[3] + rows[2]; // Proche
+        planes[5] = rows[3] - rows[2]; // Lointain
+    }
+
+    // Vrai si la boîte est (au moins partiellement) dans le frustum.
+    // On teste le sommet de la boîte le plus avancé dans la direction de la
+    // normale de chaque plan : s'il est derrière un plan, la boîte est dehors.
+    bool intersects(const AABB &box) const {
+        for (const glm::vec4 &plane : planes) {
+            glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                               plane.y >= 0.0f ? box.max.y : box.min.y,
+                               plane.z >= 0.0f ? box.max.z : box.min.z);
+            if (plane.x * positive.x + plane.y * positive.y +
+                    plane.z * positive.z + plane.w <
+                0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    glm::vec4 planes[6];
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "gl_extensions.hpp"
+
+#include <GLFW/glfw3.h>
+
+TexStorage2DProc glTexStorage2DExt = nullptr;
+bool glTextureCompressionS3TC = false;
+GetProgramBinaryProc glGetProgramBinaryExt = nullptr;
+ProgramBinaryProc glProgramBinaryExt = nullptr;
+ProgramParameteriProc glProgramParameteriExt = nullptr;
+
+// Fonction du cœur à partir de la version major.minor, ou de l'extension
+static bool supported(int major, int minor, const char *extension) {
+    return GLVersion.major > major ||
+           (GLVersion.major == major && GLVersion.minor >= minor) ||
+           glfwExtensionSupported(extension);
+}
+
+void loadGLExtensions() {
+    if (supported(4, 2, "GL_ARB_texture_storage")) {
+        glTexStorage2DExt = reinterpret_cast<TexStorage2DProc>(
+            glfwGetProcAddress("glTexStorage2D"));
+    }
+    glTextureCompressionS3TC =
+        glfwExtensionSupported("GL_EXT_texture_compression_s3tc");
+
+    if (supported(4, 1, "GL_ARB_get_program_binary")) {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats > 0) {
+            glGetProgramBinaryExt = reinterpret_cast<GetProgramBinaryProc>(
+                glfwGetProcAddress("glGetProgramBinary"));
+            glProgramBinaryExt = reinterpret_cast<ProgramBinaryProc>(
+                glfwGetProcAddress("glProgramBinary"));
+            glProgramParameteriExt = reinterpret_cast<ProgramParameteriProc>(
+                glfwGetProcAddress("glProgramParameteri"));
+        }
+        if (!glGetProgramBinaryExt || !glProgramBinaryExt ||
+            !glProgramParameteriExt) {
+            glGetProgramBinaryExt = nullptr;
+            glProgramBinaryExt = nullptr;
+            glProgramParameteriExt = nullptr;
+        }
+    }
+}
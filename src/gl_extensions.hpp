@@ -0,0 +1,46 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include "../include/glad/glad.h"
+
+// Fonctions et extensions OpenGL absentes du cœur 3.3 chargé par glad.
+// Chaque fonction reste nullptr (chaque indicateur false) tant que
+// loadGLExtensions() n'a pas été appelé, ou si le pilote ne la fournit pas :
+// l'appelant garde alors un chemin 3.3.
+
+// Stockage immuable des textures (OpenGL 4.2, ARB_texture_storage)
+typedef void(APIENTRYP TexStorage2DProc)(GLenum target, GLsizei levels,
+                                         GLenum internalFormat, GLsizei width,
+                                         GLsizei height);
+extern TexStorage2DProc glTexStorage2DExt;
+
+// Textures compressées S3TC/BC1 (EXT_texture_compression_s3tc, absente du
+// cœur) : true si le pilote les accepte
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+extern bool glTextureCompressionS3TC;
+
+// Binaires de programmes (OpenGL 4.1, ARB_get_program_binary). Les deux
+// fonctions restent nullptr si le pilote ne propose aucun format binaire.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+typedef void(APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize,
+                                             GLsizei *length,
+                                             GLenum *binaryFormat,
+                                             void *binary);
+typedef void(APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat,
+                                          const void *binary, GLsizei length);
+typedef void(APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname,
+                                              GLint value);
+extern GetProgramBinaryProc glGetProgramBinaryExt;
+extern ProgramBinaryProc glProgramBinaryExt;
+extern ProgramParameteriProc glProgramParameteriExt;
+
+// Charger les fonctions ci-dessus, avec le contexte courant (après glad)
+void loadGLExtensions();
+
+#endif
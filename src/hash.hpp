@@ -0,0 +1,38 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Hachage FNV-1a sur 64 bits : rapide, suffisant pour détecter qu'un fichier
+// source a changé (pas pour la sécurité)
+#define FNV1A_OFFSET_BASIS 0xcbf29ce484222325ull
+#define FNV1A_PRIME 0x100000001b3ull
+
+// Poursuivre le hachage hash avec size octets
+inline uint64_t fnv1a(const void *data, size_t size,
+                      uint64_t hash = FNV1A_OFFSET_BASIS) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+// Poursuivre le hachage hash avec le contenu du fichier path
+inline bool fnv1aFile(const std::string &path, uint64_t &hash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        hash = fnv1a(buffer, static_cast<size_t>(file.gcount()), hash);
+    }
+    return true;
+}
+
+#endif
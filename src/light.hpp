@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "shader.hpp"
+
 enum LightType { DIRECTIONAL, POINT, SPOT };
 
 class Light {
@@ -71,14 +73,25 @@ class Light {
         }
     }
 
-    void sendToShader(unsigned int shaderProgram) const {
-        glUniform3fv(glGetUniformLocation(shaderProgram, "light.position"), 1,
-                     &position[0]);
-        glUniform3fv(glGetUniformLocation(shaderProgram, "light.color"), 1,
-                     &color[0]);
-        glUniform1f(glGetUniformLocation(shaderProgram, "light.intensity"),
-                    intensity);
+    void sendToShader(ShaderProgram &program) const {
+        const LightUniforms &uniforms = lightUniforms.get(program);
+        program.set(uniforms.position, position);
+        program.set(uniforms.color, color);
+        program.set(uniforms.intensity, intensity);
     }
+
+  private:
+    // Uniformes de la lumière d'un programme
+    struct LightUniforms {
+        UniformHandle position, color, intensity;
+
+        explicit LightUniforms(ShaderProgram &program)
+            : position(program.uniform("light.position")),
+              color(program.uniform("light.color")),
+              intensity(program.uniform("light.intensity")) {}
+    };
+    // Pour chaque programme passé à sendToShader
+    mutable UniformCache<LightUniforms> lightUniforms;
 };
 
 #endif
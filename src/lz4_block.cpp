@@ -0,0 +1,149 @@
+#include "lz4_block.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+// Longueur minimale d'une copie
+#define LZ4_MIN_MATCH 4
+// Les 5 derniers octets sont toujours des littéraux, et la dernière copie
+// commence au moins 12 octets avant la fin (règles du format)
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_LIMIT 12
+#define LZ4_MAX_DISTANCE 65535
+#define LZ4_HASH_BITS 16
+
+static uint32_t read32(const unsigned char *bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+// Longueur au-delà de 15 : octets de 255 puis le reste
+static void writeLength(size_t length, std::vector<unsigned char> &out) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<unsigned char>(length));
+}
+
+// Écrire une séquence : littéraux puis copie (matchLength 0 : dernière
+// séquence, sans copie)
+static void writeSequence(const unsigned char *literals, size_t literalLength,
+                          size_t distance, size_t matchLength,
+                          std::vector<unsigned char> &out) {
+    const size_t matchCode = matchLength ? matchLength - LZ4_MIN_MATCH : 0;
+    out.push_back(static_cast<unsigned char>(
+        (literalLength < 15 ? literalLength : 15) << 4 |
+        (matchCode < 15 ? matchCode : 15)));
+    if (literalLength >= 15) {
+        writeLength(literalLength - 15, out);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+    if (matchLength == 0) {
+        return;
+    }
+    out.push_back(distance & 0xff);
+    out.push_back(distance >> 8);
+    if (matchCode >= 15) {
+        writeLength(matchCode - 15, out);
+    }
+}
+
+void compressLz4(const unsigned char *source, size_t size,
+                 std::vector<unsigned char> &out) {
+    out.clear();
+    out.reserve(size + size / 255 + 16);
+
+    // Dernière position vue de chaque suite de 4 octets (par hachage)
+    std::vector<int64_t> table(size_t(1) << LZ4_HASH_BITS, -1);
+    size_t anchor = 0; // Début des littéraux en attente
+    size_t position = 0;
+    while (size >= LZ4_MATCH_LIMIT && position + LZ4_MATCH_LIMIT <= size) {
+        const uint32_t sequence = read32(source + position);
+        const uint32_t hash =
+            (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+        const int64_t candidate = table[hash];
+        table[hash] = static_cast<int64_t>(position);
+        if (candidate < 0 ||
+            position - static_cast<size_t>(candidate) > LZ4_MAX_DISTANCE ||
+            read32(source + candidate) != sequence) {
+            position++;
+            continue;
+        }
+
+        size_t length = LZ4_MIN_MATCH;
+        while (position + length < size - LZ4_LAST_LITERALS &&
+               source[candidate + length] == source[position + length]) {
+            length++;
+        }
+        writeSequence(source + anchor, position - anchor,
+                      position - static_cast<size_t>(candidate), length, out);
+        position += length;
+        anchor = position;
+    }
+    writeSequence(source + anchor, size - anchor, 0, 0, out);
+}
+
+bool decompressLz4(const unsigned char *source, size_t sourceSize,
+                   unsigned char *destination, size_t destinationSize) {
+    const unsigned char *in = source;
+    const unsigned char *inEnd = source + sourceSize;
+    unsigned char *out = destination;
+    unsigned char *outEnd = destination + destinationSize;
+
+    // Longueur complétée par ses octets supplémentaires
+    auto readLength = [&](size_t &length) {
+        if (length != 15) {
+            return true;
+        }
+        unsigned char byte;
+        do {
+            if (in == inEnd) {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < inEnd) {
+        const unsigned char token = *in++;
+        size_t literalLength = token >> 4;
+        if (!readLength(literalLength) ||
+            literalLength > static_cast<size_t>(inEnd - in) ||
+            literalLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        std::memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+        if (in == inEnd) {
+            break; // Dernière séquence : pas de copie
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        const size_t distance = in[0] | (in[1] << 8);
+        in += 2;
+        size_t matchLength = token & 15;
+        if (distance == 0 ||
+            distance > static_cast<size_t>(out - destination) ||
+            !readLength(matchLength)) {
+            return false;
+        }
+        matchLength += LZ4_MIN_MATCH;
+        if (matchLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+        // Octet par octet : la copie peut recouvrir sa propre sortie
+        const unsigned char *match = out - distance;
+        for (size_t i = 0; i < matchLength; i++) {
+            out[i] = match[i];
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
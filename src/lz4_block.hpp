@@ -0,0 +1,22 @@
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#include <cstddef>
+#include <vector>
+
+// Compression au format de bloc LZ4 (séquences de littéraux suivies d'une
+// copie d'au moins 4 octets à une distance d'au plus 65535), lisible par
+// tout décompresseur LZ4. La compression, gloutonne, vise la vitesse de
+// décompression plutôt que le taux.
+
+// Compresser size octets de source dans out (remplacé)
+void compressLz4(const unsigned char *source, size_t size,
+                 std::vector<unsigned char> &out);
+
+// Décompresser un bloc de sourceSize octets en exactement destinationSize
+// octets. false si le bloc est invalide ou n'a pas cette taille une fois
+// décompressé (aucune lecture ni écriture hors des tampons).
+bool decompressLz4(const unsigned char *source, size_t sourceSize,
+                   unsigned char *destination, size_t destinationSize);
+
+#endif
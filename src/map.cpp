@@ -1,7 +1,461 @@
 #include "map.hpp"
 
-Map::Map() {
-    for (auto& row : terrain) {
-        row.fill(TerrainType::DIRT);
+#include "../include/stb/stb_image.h"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "binary_writer.hpp"
+
+Map::Map(int width, int depth)
+    : width(width), depth(depth),
+      blocksPerRow((width + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE),
+      gridWidth(width + 1),
+      roads(nullptr), roadCount(0),
+      terrainStorage(static_cast<size_t>(blocksPerRow) *
+                     ((depth + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE)),
+      heightStorage(static_cast<size_t>(width + 1) * (depth + 1)) {
+    // DIRT vaut 0 : tous les bits à zéro
+    static_assert(static_cast<int>(TerrainType::DIRT) == 0, "");
+    terrainStorage.fill(0);
+    heightStorage.fill(0.0f);
+    terrain = terrainStorage.data();
+    heights = heightStorage.data();
+    resetDirtyChunks();
+}
+
+bool Map::loadFromFile(const std::string &path) {
+    // Les cartes binaires commencent par MAP_FILE_MAGIC
+    char magic[4] = {};
+    std::ifstream(path, std::ios::binary).read(magic, sizeof(magic));
+    if (std::equal(magic, magic + 4, MAP_FILE_MAGIC)) {
+        return loadBinary(path);
+    }
+    return loadText(path);
+}
+
+// Taille du plan des types d'une carte, en mots
+static size_t terrainWordCount(int width, int depth) {
+    return static_cast<size_t>((width + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE) *
+           ((depth + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE);
+}
+
+bool Map::loadBinary(const std::string &path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(MapFileHeader)) {
+        std::cerr << "Erreur : Impossible de projeter la carte : " << path
+                  << std::endl;
+        return false;
+    }
+
+    const MapFileHeader *header =
+        reinterpret_cast<const MapFileHeader *>(file.data());
+    if (header->version != MAP_FILE_VERSION || header->width == 0 ||
+        header->depth == 0) {
+        std::cerr << "Erreur : Version ou dimensions de carte invalides : "
+                  << path << std::endl;
+        return false;
+    }
+
+    // Chaque plan doit être aligné et tenir dans le fichier
+    const size_t terrainBytes =
+        terrainWordCount(header->width, header->depth) * sizeof(uint32_t);
+    const size_t heightBytes =
+        static_cast<size_t>(header->width + 1) * (header->depth + 1) *
+        sizeof(float);
+    const size_t roadBytes = header->roadCount * sizeof(RoadSegment);
+    auto validPlane = [&](uint64_t offset, size_t bytes) {
+        return offset % MAP_FILE_ALIGNMENT == 0 && offset <= file.size() &&
+               bytes <= file.size() - offset;
+    };
+    const bool hasHeights = header->flags & MAP_FILE_HAS_HEIGHTS;
+    if (!validPlane(header->terrainOffset, terrainBytes) ||
+        (hasHeights && !validPlane(header->heightOffset, heightBytes)) ||
+        (header->roadCount > 0 && !validPlane(header->roadOffset, roadBytes))) {
+        std::cerr << "Erreur : Carte tronquée ou corrompue : " << path
+                  << std::endl;
+        return false;
+    }
+
+    // Les plans sont utilisés en place : aucune copie, aucune analyse. La
+    // carte vide de départ n'alloue rien.
+    Map loaded(0, 0);
+    loaded.width = header->width;
+    loaded.depth = header->depth;
+    loaded.blocksPerRow = (loaded.width + MAP_BLOCK_SIZE - 1) / MAP_BLOCK_SIZE;
+    loaded.gridWidth = loaded.width + 1;
+    loaded.resetDirtyChunks();
+    loaded.terrain =
+        reinterpret_cast<uint32_t *>(file.data() + header->terrainOffset);
+    if (hasHeights) {
+        loaded.heights =
+            reinterpret_cast<float *>(file.data() + header->heightOffset);
+    } else {
+        loaded.heightStorage = AlignedBuffer<float>(heightBytes / sizeof(float));
+        loaded.heightStorage.fill(0.0f);
+        loaded.heights = loaded.heightStorage.data();
+    }
+    loaded.roadCount = header->roadCount;
+    loaded.roads = header->roadCount > 0
+                       ? reinterpret_cast<const RoadSegment *>(
+                             file.data() + header->roadOffset)
+                       : nullptr;
+    loaded.mappedFile = std::move(file);
+    *this = std::move(loaded);
+    return true;
+}
+
+bool Map::saveBinary(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Erreur : Impossible d'écrire la carte : " << path
+                  << std::endl;
+        return false;
+    }
+
+    auto align = [](uint64_t offset) {
+        return alignOffset(offset, MAP_FILE_ALIGNMENT);
+    };
+    const size_t terrainBytes = terrainWordCount(width, depth) * sizeof(uint32_t);
+    const size_t heightBytes =
+        static_cast<size_t>(gridWidth) * (depth + 1) * sizeof(float);
+
+    MapFileHeader header = {};
+    std::copy(MAP_FILE_MAGIC, MAP_FILE_MAGIC + 4, header.magic);
+    header.version = MAP_FILE_VERSION;
+    header.width = width;
+    header.depth = depth;
+    header.flags = MAP_FILE_HAS_HEIGHTS;
+    header.roadCount = static_cast<uint32_t>(roadCount);
+    header.terrainOffset = align(sizeof(MapFileHeader));
+    header.heightOffset = align(header.terrainOffset + terrainBytes);
+    header.roadOffset =
+        roadCount > 0 ? align(header.heightOffset + heightBytes) : 0;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeAt(file, header.terrainOffset, terrain, terrainBytes);
+    writeAt(file, header.heightOffset, heights, heightBytes);
+    if (roadCount > 0) {
+        writeAt(file, header.roadOffset, roads,
+                roadCount * sizeof(RoadSegment));
+    }
+
+    if (!file) {
+        std::cerr << "Erreur : Écriture incomplète de la carte : " << path
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Map::resetDirtyChunks() {
+    chunksX = (width + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+    chunksZ = (depth + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+    chunkDirty.assign(static_cast<size_t>(chunksX) * chunksZ, false);
+    dirtyChunks.clear();
+    dirtyTiles.clear();
+}
+
+void Map::markDirty(int minX, int minZ, int maxX, int maxZ) {
+    // Le morceau c couvre les points [c * MAP_CHUNK_SIZE,
+    // (c + 1) * MAP_CHUNK_SIZE]
+    const int firstX = std::max(minX - 1, 0) / MAP_CHUNK_SIZE;
+    const int firstZ = std::max(minZ - 1, 0) / MAP_CHUNK_SIZE;
+    const int lastX = std::min(std::max(maxX, 0) / MAP_CHUNK_SIZE, chunksX - 1);
+    const int lastZ = std::min(std::max(maxZ, 0) / MAP_CHUNK_SIZE, chunksZ - 1);
+    for (int chunkZ = firstZ; chunkZ <= lastZ; chunkZ++) {
+        for (int chunkX = firstX; chunkX <= lastX; chunkX++) {
+            const size_t index = static_cast<size_t>(chunkZ) * chunksX + chunkX;
+            if (!chunkDirty[index]) {
+                chunkDirty[index] = true;
+                dirtyChunks.push_back({chunkX, chunkZ});
+            }
+        }
+    }
+}
+
+std::vector<MapChunk> Map::takeDirtyChunks() {
+    std::vector<MapChunk> taken;
+    taken.swap(dirtyChunks);
+    for (const MapChunk &chunk : taken) {
+        chunkDirty[static_cast<size_t>(chunk.z) * chunksX + chunk.x] = false;
+    }
+    return taken;
+}
+
+void Map::addRoad(const RoadSegment &road) {
+    roadStorage.push_back(road);
+    roads = roadStorage.data();
+    roadCount = roadStorage.size();
+
+    // Recouvrir les cases dont le centre est à moins de width / 2 du segment
+    const glm::vec2 start(road.startX, road.startZ);
+    const glm::vec2 end(road.endX, road.endZ);
+    const glm::vec2 segment = end - start;
+    const float lengthSquared = glm::dot(segment, segment);
+    const float halfWidth = road.width * 0.5f;
+
+    const int minX = std::max(0, static_cast<int>(std::floor(
+                                     std::min(start.x, end.x) - halfWidth)));
+    const int maxX = std::min(width - 1, static_cast<int>(std::ceil(
+                                             std::max(start.x, end.x) + halfWidth)));
+    const int minZ = std::max(0, static_cast<int>(std::floor(
+                                     std::min(start.y, end.y) - halfWidth)));
+    const int maxZ = std::min(depth - 1, static_cast<int>(std::ceil(
+                                             std::max(start.y, end.y) + halfWidth)));
+    for (int z = minZ; z <= maxZ; z++) {
+        for (int x = minX; x <= maxX; x++) {
+            glm::vec2 center(x + 0.5f, z + 0.5f);
+            float t = lengthSquared > 0.0f
+                          ? glm::clamp(glm::dot(center - start, segment) /
+                                           lengthSquared,
+                                       0.0f, 1.0f)
+                          : 0.0f;
+            if (glm::length(center - (start + segment * t)) <= halfWidth) {
+                setTile(x, z, static_cast<TerrainType>(road.type));
+            }
+        }
+    }
+}
+
+bool Map::loadText(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Erreur : Impossible d'ouvrir la carte : " << path
+                  << std::endl;
+        return false;
+    }
+
+    bool sized = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string keyword;
+        if (!(stream >> keyword) || keyword[0] == '#') {
+            continue; // Ligne vide ou commentaire
+        }
+
+        bool valid = true;
+        if (keyword == "size") {
+            // size <largeur> <profondeur>
+            int newWidth, newDepth;
+            valid = static_cast<bool>(stream >> newWidth >> newDepth) &&
+                    newWidth > 0 && newDepth > 0;
+            if (valid) {
+                *this = Map(newWidth, newDepth);
+                sized = true;
+            }
+        } else if (!sized) {
+            std::cerr << "Erreur : " << path
+                      << " : la taille doit être donnée en premier"
+                      << std::endl;
+            return false;
+        } else if (keyword == "heightmap") {
+            // heightmap <fichier> <hauteur max>
+            std::string heightmapPath;
+            float scale;
+            valid = static_cast<bool>(stream >> heightmapPath >> scale) &&
+                    loadHeightmap(heightmapPath, scale);
+        } else if (keyword == "hills") {
+            // hills <graine> <amplitude>
+            unsigned int seed;
+            float amplitude;
+            valid = static_cast<bool>(stream >> seed >> amplitude);
+            if (valid) {
+                generateHeights(seed, amplitude);
+            }
+        } else if (keyword == "road") {
+            // road <x0> <z0> <x1> <z1> <largeur>
+            RoadSegment road;
+            valid = static_cast<bool>(stream >> road.startX >> road.startZ >>
+                                      road.endX >> road.endZ >> road.width) &&
+                    road.width > 0.0f;
+            road.type = static_cast<uint32_t>(TerrainType::ROAD);
+            if (valid) {
+                addRoad(road);
+            }
+        } else if (keyword == "fill") {
+            // fill <DIRT|ROAD|GRAVEL> <x> <z> <largeur> <profondeur>
+            std::string typeName;
+            int x0, z0, w, d;
+            valid = static_cast<bool>(stream >> typeName >> x0 >> z0 >> w >> d);
+            TerrainType type = TerrainType::DIRT;
+            if (typeName == "ROAD") {
+                type = TerrainType::ROAD;
+            } else if (typeName == "GRAVEL") {
+                type = TerrainType::GRAVEL;
+            } else if (typeName != "DIRT") {
+                valid = false;
+            }
+            for (int z = std::max(z0, 0); valid && z < std::min(z0 + d, depth);
+                 z++) {
+                for (int x = std::max(x0, 0); x < std::min(x0 + w, width);
+                     x++) {
+                    setTile(x, z, type);
+                }
+            }
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Erreur : " << path << ":" << lineNumber
+                      << " : ligne invalide : " << line << std::endl;
+            return false;
+        }
+    }
+
+    if (!sized) {
+        std::cerr << "Erreur : " << path << " : taille de carte manquante"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Map::getTerrainRegion(int startX, int startZ, int regionWidth,
+                           int regionDepth, TerrainType *out) const {
+    const int endX = startX + regionWidth;
+    const int endZ = startZ + regionDepth;
+    for (int blockZ = startZ / MAP_BLOCK_SIZE * MAP_BLOCK_SIZE; blockZ < endZ;
+         blockZ += MAP_BLOCK_SIZE) {
+        for (int blockX = startX / MAP_BLOCK_SIZE * MAP_BLOCK_SIZE;
+             blockX < endX; blockX += MAP_BLOCK_SIZE) {
+            const uint32_t block =
+                terrain[(blockZ / MAP_BLOCK_SIZE) * blocksPerRow +
+                        blockX / MAP_BLOCK_SIZE];
+
+            // Partie du bloc comprise dans la zone
+            const int fromZ = std::max(blockZ, startZ);
+            const int toZ = std::min(blockZ + MAP_BLOCK_SIZE, endZ);
+            const int fromX = std::max(blockX, startX);
+            const int toX = std::min(blockX + MAP_BLOCK_SIZE, endX);
+            for (int z = fromZ; z < toZ; z++) {
+                TerrainType *row = out + (z - startZ) * regionWidth;
+                for (int x = fromX; x < toX; x++) {
+                    row[x - startX] = static_cast<TerrainType>(
+                        (block >> tileShift(x, z)) & 0x3);
+                }
+            }
+        }
+    }
+}
+
+bool Map::loadHeightmap(const std::string &path, float heightScale) {
+    std::vector<uint16_t> samples;
+    int imageWidth = 0, imageHeight = 0;
+
+    std::string extension = path.substr(path.find_last_of('.') + 1);
+    if (extension == "raw" || extension == "r16") {
+        // Fichier brut : carré d'entiers 16 bits little-endian
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            std::cerr << "Erreur : Impossible d'ouvrir la heightmap : " << path
+                      << std::endl;
+            return false;
+        }
+        size_t count = static_cast<size_t>(file.tellg()) / 2;
+        imageWidth = imageHeight = static_cast<int>(std::sqrt(static_cast<double>(count)));
+        if (imageWidth < 2 ||
+            static_cast<size_t>(imageWidth) * imageWidth != count) {
+            std::cerr << "Erreur : Heightmap brute non carrée : " << path
+                      << std::endl;
+            return false;
+        }
+        std::vector<unsigned char> bytes(count * 2);
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(bytes.data()), bytes.size());
+        samples.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            samples[i] = bytes[2 * i] | (bytes[2 * i + 1] << 8);
+        }
+    } else {
+        int channels;
+        stbi_us *data = stbi_load_16(path.c_str(), &imageWidth, &imageHeight,
+                                     &channels, 1);
+        if (!data) {
+            std::cerr << "Erreur : Impossible de charger la heightmap : " << path
+                      << std::endl;
+            return false;
+        }
+        samples.assign(data,
+                       data + static_cast<size_t>(imageWidth) * imageHeight);
+        stbi_image_free(data);
+        if (imageWidth < 2 || imageHeight < 2) {
+            std::cerr << "Erreur : Heightmap trop petite : " << path
+                      << std::endl;
+            return false;
+        }
+    }
+
+    // Rééchantillonnage bilinéaire de l'image sur la grille de la carte
+    for (int z = 0; z <= depth; z++) {
+        float imageY = static_cast<float>(z) * (imageHeight - 1) / depth;
+        int y0 = std::min(static_cast<int>(imageY), imageHeight - 2);
+        float v = imageY - y0;
+        for (int x = 0; x <= width; x++) {
+            float imageX = static_cast<float>(x) * (imageWidth - 1) / width;
+            int x0 = std::min(static_cast<int>(imageX), imageWidth - 2);
+            float u = imageX - x0;
+
+            const uint16_t *row0 = &samples[y0 * imageWidth + x0];
+            const uint16_t *row1 = row0 + imageWidth;
+            float h0 = row0[0] + (row0[1] - row0[0]) * u;
+            float h1 = row1[0] + (row1[1] - row1[0]) * u;
+            heights[z * gridWidth + x] =
+                (h0 + (h1 - h0) * v) / 65535.0f * heightScale;
+        }
+    }
+    return true;
+}
+
+// Valeur pseudo-aléatoire dans [0, 1] associée à un point entier
+static float latticeValue(int x, int z, unsigned int seed) {
+    uint32_t h = static_cast<uint32_t>(x) * 0x8da6b343u ^
+                 static_cast<uint32_t>(z) * 0xd8163841u ^ seed * 0xcb1ab31fu;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return static_cast<float>(h & 0xffffff) / static_cast<float>(0xffffff);
+}
+
+// Bruit de valeur : interpolation lissée des valeurs du réseau entier
+static float valueNoise(float x, float z, unsigned int seed) {
+    int x0 = static_cast<int>(std::floor(x));
+    int z0 = static_cast<int>(std::floor(z));
+    float u = x - x0;
+    float v = z - z0;
+    u = u * u * (3.0f - 2.0f * u);
+    v = v * v * (3.0f - 2.0f * v);
+    float h0 = latticeValue(x0, z0, seed) +
+               (latticeValue(x0 + 1, z0, seed) - latticeValue(x0, z0, seed)) * u;
+    float h1 = latticeValue(x0, z0 + 1, seed) +
+               (latticeValue(x0 + 1, z0 + 1, seed) -
+                latticeValue(x0, z0 + 1, seed)) *
+                   u;
+    return h0 + (h1 - h0) * v;
+}
+
+void Map::generateHeights(unsigned int seed, float amplitude) {
+    const int octaves = 5;
+    for (int z = 0; z <= depth; z++) {
+        for (int x = 0; x <= width; x++) {
+            float frequency = 1.0f / 64.0f;
+            float weight = 1.0f;
+            float sum = 0.0f, totalWeight = 0.0f;
+            for (int octave = 0; octave < octaves; octave++) {
+                sum += weight * valueNoise(x * frequency, z * frequency,
+                                           seed + octave);
+                totalWeight += weight;
+                frequency *= 2.0f;
+                weight *= 0.5f;
+            }
+            heights[z * gridWidth + x] = sum / totalWeight * amplitude;
+        }
     }
 }
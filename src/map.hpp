@@ -3,23 +3,179 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
 
-#define MAP_SIZE 256
+#include "aligned_buffer.hpp"
+#include "map_file.hpp"
+#include "mapped_file.hpp"
 
-enum class TerrainType {
+// Les types de case sont rangés par blocs de 4 x 4 cases, 2 bits par case :
+// un bloc tient dans un mot de 32 bits
+#define MAP_BLOCK_SIZE 4
+// Taille (en cases) des morceaux dont la carte suit les modifications ; ce
+// sont aussi les morceaux du terrain dessiné (voir Terrain)
+#define MAP_CHUNK_SIZE 32
+
+enum class TerrainType : uint8_t {
     DIRT,
     ROAD,
     GRAVEL
+    // 2 bits par case : 4 types au plus
+};
+
+// Morceau de MAP_CHUNK_SIZE x MAP_CHUNK_SIZE cases, repéré par son rang en x
+// et en z
+struct MapChunk {
+    int x, z;
+};
+
+// Case de la carte
+struct MapTile {
+    int x, z;
 };
 
 class Map{
     private:
-    std::array<std::array<TerrainType, MAP_SIZE>, MAP_SIZE> terrain;
+    int width, depth;     // Nombre de cases en x et en z
+    int blocksPerRow;     // Nombre de blocs de 4 x 4 cases en x
+    int gridWidth;        // Nombre de points de la grille en x (width + 1)
+    // Un mot par bloc de 4 x 4 cases, blocs rangés ligne par ligne ; dans un
+    // bloc, les cases suivent l'ordre de Morton (voir tileShift). 256 x 256
+    // cases tiennent en 16 Kio au lieu de 256 Kio.
+    uint32_t *terrain;
+    // Hauteur de chaque point de la grille, rangée ligne par ligne :
+    // heights[z * gridWidth + x]
+    float *heights;
+    const RoadSegment *roads;
+    size_t roadCount;
+
+    // Les plans pointent soit dans ces tableaux, soit directement dans le
+    // fichier .bmap projeté en mémoire
+    AlignedBuffer<uint32_t> terrainStorage;
+    AlignedBuffer<float> heightStorage;
+    std::vector<RoadSegment> roadStorage;
+    MappedFile mappedFile;
+
+    // Morceaux modifiés par setGridHeight depuis le dernier takeDirtyChunks,
+    // chacun une seule fois
+    int chunksX, chunksZ;
+    std::vector<bool> chunkDirty; // chunkDirty[z * chunksX + x]
+    std::vector<MapChunk> dirtyChunks;
+    // Cases modifiées par setTerrainAt depuis le dernier takeDirtyTiles
+    std::vector<MapTile> dirtyTiles;
     public:
-    Map();
-    TerrainType getTerrainAt(int x, int z) const { return terrain[x][z]; };
-    glm::vec3 getTerrainColor(TerrainType type) {
+    // Carte plate de width x depth cases, entièrement en terre
+    Map(int width, int depth);
+
+    // Charger une carte : fichier binaire .bmap (reconnu à son en-tête,
+    // projeté en mémoire, voir map_file.hpp) ou description texte (voir
+    // maps/default.map) donnant dimensions, relief, zones et routes. La carte
+    // est réallouée à la taille lue.
+    bool loadFromFile(const std::string &path);
+    // Écrire la carte au format binaire .bmap
+    bool saveBinary(const std::string &path) const;
+
+    int getWidth() const { return width; }
+    int getDepth() const { return depth; }
+
+    const RoadSegment *getRoads() const { return roads; }
+    size_t getRoadCount() const { return roadCount; }
+
+    TerrainType getTerrainAt(int x, int z) const {
+        uint32_t block = terrain[(z / MAP_BLOCK_SIZE) * blocksPerRow +
+                                 x / MAP_BLOCK_SIZE];
+        return static_cast<TerrainType>((block >> tileShift(x, z)) & 0x3);
+    };
+
+    // Modifier une case en cours de partie ; la case est notée comme
+    // modifiée. Les types ne sont pas dans les sommets du terrain : aucun
+    // morceau n'est à reconstruire.
+    void setTerrainAt(int x, int z, TerrainType type) {
+        setTile(x, z, type);
+        dirtyTiles.push_back({x, z});
+    }
+
+    // Copier les types des cases [startX, startX + regionWidth) x
+    // [startZ, startZ + regionDepth) dans out, rangés ligne par ligne :
+    // out[z * regionWidth + x]. Chaque bloc n'est lu qu'une fois.
+    void getTerrainRegion(int startX, int startZ, int regionWidth,
+                          int regionDepth, TerrainType *out) const;
+
+    // Charger les hauteurs depuis une image 16 bits (PNG...) ou un fichier
+    // brut .raw/.r16 (entiers 16 bits little-endian, carré). L'image est
+    // rééchantillonnée sur la grille ; 65535 correspond à heightScale.
+    bool loadHeightmap(const std::string &path, float heightScale);
+    // Générer des collines (bruit de valeur fractal) d'amplitude donnée
+    void generateHeights(unsigned int seed, float amplitude);
+
+    // Hauteur exacte d'un point de la grille (0 <= x <= width,
+    // 0 <= z <= depth)
+    float getGridHeight(int x, int z) const {
+        return heights[z * gridWidth + x];
+    }
+
+    // Modifier la hauteur d'un point de la grille en cours de partie
+    // (déformation du sol). Les morceaux contenant le point et ses voisins,
+    // dont les normales changent, sont notés comme modifiés.
+    void setGridHeight(int x, int z, float height) {
+        heights[z * gridWidth + x] = height;
+        markDirty(x - 1, z - 1, x + 1, z + 1);
+    }
+
+    bool hasDirtyChunks() const { return !dirtyChunks.empty(); }
+    // Renvoyer les morceaux modifiés depuis le dernier appel et les
+    // considérer comme à jour
+    std::vector<MapChunk> takeDirtyChunks();
+
+    bool hasDirtyTiles() const { return !dirtyTiles.empty(); }
+    // Renvoyer les cases modifiées depuis le dernier appel
+    std::vector<MapTile> takeDirtyTiles() {
+        std::vector<MapTile> taken;
+        taken.swap(dirtyTiles);
+        return taken;
+    }
+
+    // Hauteur interpolée (bilinéaire) en un point quelconque de la carte.
+    // Appelée pour chaque véhicule à chaque image : pas d'allocation, deux
+    // lignes contiguës lues.
+    float getHeightAt(float x, float z) const {
+        int cellX, cellZ;
+        float u, v;
+        locateCell(x, z, cellX, cellZ, u, v);
+        const float *row0 = &heights[cellZ * gridWidth + cellX];
+        const float *row1 = row0 + gridWidth;
+        float h0 = row0[0] + (row0[1] - row0[0]) * u;
+        float h1 = row1[0] + (row1[1] - row1[0]) * u;
+        return h0 + (h1 - h0) * v;
+    }
+
+    // Normale de la surface bilinéaire au même point
+    glm::vec3 getNormalAt(float x, float z) const {
+        int cellX, cellZ;
+        float u, v;
+        locateCell(x, z, cellX, cellZ, u, v);
+        const float *row0 = &heights[cellZ * gridWidth + cellX];
+        const float *row1 = row0 + gridWidth;
+        float dx = (row0[1] - row0[0]) + ((row1[1] - row1[0]) -
+                                          (row0[1] - row0[0])) * v;
+        float dz = (row1[0] - row0[0]) + ((row1[1] - row0[1]) -
+                                          (row1[0] - row0[0])) * u;
+        return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+    }
+
+    // Normale lissée d'un point de la grille (différences centrées)
+    glm::vec3 getGridNormal(int x, int z) const {
+        float left = getGridHeight(std::max(x - 1, 0), z);
+        float right = getGridHeight(std::min(x + 1, width), z);
+        float back = getGridHeight(x, std::max(z - 1, 0));
+        float front = getGridHeight(x, std::min(z + 1, depth));
+        return glm::normalize(glm::vec3(left - right, 2.0f, back - front));
+    }
+
+    glm::vec3 getTerrainColor(TerrainType type) const {
         switch (type) {
             case TerrainType::DIRT:
                 return glm::vec3(0.6f, 0.3f, 0.0f); // Terre (marron)
@@ -31,7 +187,46 @@ class Map{
                 return glm::vec3(0.0f, 0.0f, 0.0f); // Couleur par défaut
         }
     }
-    
+
+    private:
+    bool loadBinary(const std::string &path);
+    bool loadText(const std::string &path);
+    // Ajouter un tronçon de route et recouvrir les cases qu'il traverse
+    void addRoad(const RoadSegment &road);
+
+    // Écrire le type d'une case
+    void setTile(int x, int z, TerrainType type) {
+        uint32_t &block = terrain[(z / MAP_BLOCK_SIZE) * blocksPerRow +
+                                  x / MAP_BLOCK_SIZE];
+        int shift = tileShift(x, z);
+        block = (block & ~(0x3u << shift)) |
+                (static_cast<uint32_t>(type) << shift);
+    }
+
+    // Noter comme modifiés les morceaux contenant un point de la grille de
+    // [minX, maxX] x [minZ, maxZ] (un point sur un bord appartient aux deux
+    // morceaux voisins)
+    void markDirty(int minX, int minZ, int maxX, int maxZ);
+    // Dimensionner le suivi des modifications selon width et depth
+    void resetDirtyChunks();
+
+    // Position (en bits) de la case (x, z) dans le mot de son bloc : les bits
+    // de x et z sont entrelacés (ordre de Morton), deux bits par case
+    static int tileShift(int x, int z) {
+        return ((x & 1) | (z & 1) << 1 | (x & 2) << 1 | (z & 2) << 2) * 2;
+    }
+
+    // Case contenant le point (x, z), ramené dans la carte, et position
+    // relative (u, v) dans cette case
+    void locateCell(float x, float z, int &cellX, int &cellZ, float &u,
+                    float &v) const {
+        x = std::clamp(x, 0.0f, static_cast<float>(width));
+        z = std::clamp(z, 0.0f, static_cast<float>(depth));
+        cellX = std::min(static_cast<int>(x), width - 1);
+        cellZ = std::min(static_cast<int>(z), depth - 1);
+        u = x - cellX;
+        v = z - cellZ;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+#include <cstdint>
+
+// Format binaire des cartes (.bmap), lu par projection en mémoire sans
+// analyse : les plans sont exactement la représentation de Map en mémoire.
+//
+//   MapFileHeader
+//   plan des types   : mots de 32 bits, blocs de 4 x 4 cases (voir Map)
+//   plan des hauteurs: floats, (width + 1) x (depth + 1), ligne par ligne
+//                      (facultatif, voir MAP_FILE_HAS_HEIGHTS)
+//   routes           : roadCount x RoadSegment
+//
+// Chaque plan commence sur une frontière de MAP_FILE_ALIGNMENT octets (une
+// page) pour être utilisable tel quel. Les entiers et floats sont stockés
+// dans l'ordre little-endian de la machine.
+
+#define MAP_FILE_MAGIC "OGLM"
+#define MAP_FILE_VERSION 1
+#define MAP_FILE_ALIGNMENT 4096
+
+// Drapeaux de MapFileHeader::flags
+#define MAP_FILE_HAS_HEIGHTS 0x1
+
+struct MapFileHeader {
+    char magic[4]; // MAP_FILE_MAGIC
+    uint32_t version;
+    uint32_t width, depth;
+    uint32_t flags;
+    uint32_t roadCount;
+    uint64_t terrainOffset; // Position du plan des types dans le fichier
+    uint64_t heightOffset;  // 0 si pas de plan des hauteurs
+    uint64_t roadOffset;    // 0 si pas de route
+};
+
+// Tronçon de route : segment de (startX, startZ) à (endX, endZ), en cases
+struct RoadSegment {
+    float startX, startZ;
+    float endX, endZ;
+    float width;
+    uint32_t type; // TerrainType du revêtement
+};
+
+static_assert(sizeof(MapFileHeader) == 48, "En-tête de carte mal aligné");
+static_assert(sizeof(RoadSegment) == 24, "Tronçon de route mal aligné");
+
+#endif
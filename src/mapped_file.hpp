@@ -0,0 +1,75 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+// Fichier projeté en mémoire (mmap). La projection est privée : les pages
+// restent celles du cache du système, partagées avec les autres processus
+// qui lisent le même fichier, tant qu'elles ne sont pas modifiées (copie sur
+// écriture). Le fichier sur disque n'est jamais modifié.
+class MappedFile {
+  public:
+    MappedFile() : mappedData(nullptr), mappedSize(0) {}
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+        : mappedData(other.mappedData), mappedSize(other.mappedSize) {
+        other.mappedData = nullptr;
+        other.mappedSize = 0;
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        std::swap(mappedData, other.mappedData);
+        std::swap(mappedSize, other.mappedSize);
+        return *this;
+    }
+
+    ~MappedFile() { close(); }
+
+    bool open(const std::string &path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0 || status.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void *address = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE, fd, 0);
+        ::close(fd); // La projection garde sa propre référence au fichier
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        mappedData = static_cast<unsigned char *>(address);
+        mappedSize = static_cast<size_t>(status.st_size);
+        return true;
+    }
+
+    void close() {
+        if (mappedData) {
+            munmap(mappedData, mappedSize);
+        }
+        mappedData = nullptr;
+        mappedSize = 0;
+    }
+
+    unsigned char *data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+    bool isOpen() const { return mappedData != nullptr; }
+
+  private:
+    unsigned char *mappedData;
+    size_t mappedSize;
+};
+
+#endif
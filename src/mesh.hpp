@@ -0,0 +1,120 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include "../include/glad/glad.h"
+#include <algorithm>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+#include "mesh_file.hpp"
+#include "shader.hpp"
+
+// Modèle envoyé au GPU, partagé entre toutes les instances qui le dessinent
+// (voir MeshCache). Les tampons sont libérés avec le dernier propriétaire.
+// Sommets au format MeshVertexFormat. Toutes les parties du modèle partagent
+// un VBO et un EBO ; chacune est un SubMesh. Les indices sont sur 16 bits
+// quand toutes les parties ont moins de 65536 sommets. Chaque niveau de
+// détail (MeshLod) est une plage de submeshes qui réutilise les sommets du
+// niveau 0.
+struct Mesh {
+    unsigned int vao, vbo, ebo;
+    MeshVertexFormat format;
+    unsigned int indexType; // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
+    std::vector<SubMesh> submeshes;
+    std::vector<MeshLod> lods; // Du plus détaillé au plus simplifié
+    std::vector<glm::vec3> materialColors; // Palette des sommets compressés
+    glm::vec3 boundsMin, boundsMax; // Boîte englobante dans son repère
+    glm::vec3 center;               // Centre de la boîte
+
+    Mesh()
+        : vao(0), vbo(0), ebo(0), format(MeshVertexFormat::FLOAT),
+          indexType(GL_UNSIGNED_INT), boundsMin(0.0f), boundsMax(0.0f), center(0.0f) {}
+    Mesh(const Mesh &) = delete;
+    Mesh &operator=(const Mesh &) = delete;
+
+    ~Mesh() {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+    }
+
+    // Échanger le contenu de deux modèles : un modèle rechargé garde son
+    // objet, partagé par ses instances
+    void swap(Mesh &other) {
+        std::swap(vao, other.vao);
+        std::swap(vbo, other.vbo);
+        std::swap(ebo, other.ebo);
+        std::swap(format, other.format);
+        std::swap(indexType, other.indexType);
+        submeshes.swap(other.submeshes);
+        lods.swap(other.lods);
+        materialColors.swap(other.materialColors);
+        std::swap(boundsMin, other.boundsMin);
+        std::swap(boundsMax, other.boundsMax);
+        std::swap(center, other.center);
+    }
+
+    // Uniformes de décodage des sommets d'un programme
+    struct VertexFormatUniforms {
+        UniformHandle packedVertices, positionScale, positionOffset,
+            materialColors;
+
+        explicit VertexFormatUniforms(ShaderProgram &program)
+            : packedVertices(program.uniform("packedVertices")),
+              positionScale(program.uniform("positionScale")),
+              positionOffset(program.uniform("positionOffset")),
+              materialColors(program.uniform("materialColors")) {}
+    };
+
+    // Envoyer au programme actif de quoi décoder les sommets : positions
+    // quantifiées dans la boîte englobante et palette des matériaux
+    void bindVertexFormat(ShaderProgram &program,
+                          const VertexFormatUniforms &uniforms) const {
+        const bool packed = format == MeshVertexFormat::PACKED;
+        program.set(uniforms.packedVertices, packed);
+        if (!packed) {
+            return;
+        }
+        program.set(uniforms.positionScale, (boundsMax - boundsMin) / 65535.0f);
+        program.set(uniforms.positionOffset, boundsMin);
+        if (!materialColors.empty()) {
+            program.set(uniforms.materialColors, materialColors.data(),
+                        static_cast<int>(materialColors.size()));
+        }
+    }
+
+    int getLodCount() const { return static_cast<int>(lods.size()); }
+
+    // Niveau de détail le plus simplifié dont l'écart, vu à pixelsPerUnit
+    // pixels par unité du modèle, reste sous pixelError pixels
+    int selectLod(float pixelsPerUnit, float pixelError) const {
+        int lod = 0;
+        while (lod + 1 < getLodCount() &&
+               lods[lod + 1].error * pixelsPerUnit <= pixelError) {
+            lod++;
+        }
+        return lod;
+    }
+
+    // Dessiner instanceCount fois le niveau de détail lod. Le VAO du modèle
+    // doit déjà être lié, avec les attributs d'instance (voir CarRenderer).
+    void drawInstanced(int lod, int instanceCount) const {
+        if (lods.empty()) {
+            return;
+        }
+        const MeshLod &level = lods[std::clamp(lod, 0, getLodCount() - 1)];
+        const size_t indexSize =
+            indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        for (uint32_t i = 0; i < level.submeshCount; i++) {
+            const SubMesh &submesh = submeshes[level.firstSubmesh + i];
+            glDrawElementsInstancedBaseVertex(
+                GL_TRIANGLES, submesh.indexCount, indexType,
+                (void *)(submesh.firstIndex * indexSize), instanceCount,
+                submesh.baseVertex);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "asset_loader.hpp"
+#include "mesh.hpp"
+#include "mesh_file.hpp"
+#include "mesh_optimizer.hpp"
+#include "mesh_simplifier.hpp"
+#include "model_loader.hpp"
+#include "virtual_file_system.hpp"
+
+// Modèles chargés, indexés par chemin : chaque fichier n'est importé et
+// envoyé au GPU qu'une fois, quel que soit le nombre d'instances. Le cache
+// ne garde qu'une référence faible : un modèle que plus personne n'utilise
+// est libéré, et rechargé à la demande suivante.
+//
+// Au premier chargement, le modèle importé est optimisé (voir
+// mesh_optimizer.hpp), complété de ses niveaux de détail (voir
+// mesh_simplifier.hpp) puis écrit à côté de sa source
+// (chemin + MESH_FILE_EXTENSION) ; les lancements suivants le projettent en
+// mémoire tant que la source et ses matériaux n'ont pas changé.
+class MeshCache {
+  public:
+    // Les modèles sont envoyés au GPU avec des sommets au format donné
+    explicit MeshCache(MeshVertexFormat format = MeshVertexFormat::PACKED)
+        : format(format) {}
+
+    // Modèle du fichier path, importé en arrière-plan par loader. Le modèle
+    // renvoyé reste vide (sans niveau de détail, il n'est pas dessiné)
+    // jusqu'à ce que loader.processUploads() l'envoie au GPU ; il le reste
+    // si le chargement échoue.
+    std::shared_ptr<Mesh> load(const std::string &path, AssetLoader &loader) {
+        std::weak_ptr<Mesh> &entry = meshes[path];
+        std::shared_ptr<Mesh> mesh = entry.lock();
+        if (mesh) {
+            return mesh; // Déjà chargé, ou en cours de chargement
+        }
+
+        mesh = std::make_shared<Mesh>();
+        entry = mesh;
+        loadAsync(path, mesh, loader);
+        return mesh;
+    }
+
+    // Recharger en arrière-plan les modèles chargés du répertoire de
+    // changedPath (le fichier modifié peut être un modèle ou ses matériaux).
+    // Chaque modèle garde son objet Mesh, dont le contenu est remplacé à
+    // l'envoi.
+    void reload(const std::string &changedPath, AssetLoader &loader) {
+        const std::filesystem::path directory =
+            std::filesystem::path(VirtualFileSystem::normalizePath(changedPath))
+                .parent_path();
+        for (auto &[path, entry] : meshes) {
+            std::shared_ptr<Mesh> mesh = entry.lock();
+            if (mesh && std::filesystem::path(
+                            VirtualFileSystem::normalizePath(path))
+                                .parent_path() == directory) {
+                std::cout << "Rechargement du modèle : " << path << std::endl;
+                loadAsync(path, mesh, loader);
+            }
+        }
+    }
+
+  private:
+    MeshVertexFormat format;
+    std::unordered_map<std::string, std::weak_ptr<Mesh>> meshes;
+
+    // Préparer le modèle path sur un thread de loader puis l'envoyer au GPU
+    // à la place du contenu de mesh
+    void loadAsync(const std::string &path, std::shared_ptr<Mesh> mesh,
+                   AssetLoader &loader) {
+        const MeshVertexFormat format = this->format;
+        loader.load([path, format, mesh]() -> AssetLoader::UploadStep {
+            std::shared_ptr<PreparedMesh> prepared =
+                prepareModel(path, format);
+            if (!prepared) {
+                return nullptr;
+            }
+            return [prepared, mesh] {
+                Mesh uploaded;
+                uploadPreparedMesh(*prepared, uploaded);
+                mesh->swap(uploaded); // L'ancien contenu part avec uploaded
+            };
+        });
+    }
+
+    // Lire et décoder le modèle du fichier path, sans OpenGL
+    static std::shared_ptr<PreparedMesh> prepareModel(const std::string &path,
+                                                      MeshVertexFormat format) {
+        // Modèle précalculé encore à jour : Assimp n'est pas utilisé
+        const std::string bakedPath = path + MESH_FILE_EXTENSION;
+        uint64_t sourceHash = 0;
+        const bool hashed = hashModelSources(path, sourceHash);
+        if (hashed) {
+            std::shared_ptr<PreparedMesh> prepared =
+                prepareBakedMesh(bakedPath, sourceHash, format);
+            if (prepared) {
+                return prepared;
+            }
+        }
+
+        ModelData model;
+        if (!loadModelData(path, model)) {
+            return nullptr;
+        }
+        optimizeModel(model);
+        buildModelLods(model);
+        const MeshVertexFormat modelFormat =
+            modelVertexFormat(path, model, format);
+        if (hashed) {
+            saveBakedModel(bakedPath, model, sourceHash, modelFormat);
+        }
+        return prepareMesh(std::move(model), modelFormat);
+    }
+};
+
+#endif
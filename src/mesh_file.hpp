@@ -0,0 +1,94 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Format binaire des modèles précalculés (.mesh), écrit au premier
+// chargement d'un modèle et projeté en mémoire aux lancements suivants :
+// les tableaux sont exactement ceux envoyés au GPU.
+//
+//   MeshFileHeader
+//   sommets      : vertexCount x MODEL_VERTEX_FLOATS floats (voir ModelData)
+//                  ou vertexCount x PackedModelVertex selon vertexFormat
+//   indices      : indexCount x uint16 ou uint32 (indexSize), relatifs au
+//                  premier sommet de leur sous-mesh
+//   sous-meshes  : submeshCount x SubMesh, niveau de détail par niveau de
+//                  détail
+//   matériaux    : materialCount x 3 floats (couleur diffuse)
+//   niveaux      : lodCount x MeshLod, du plus détaillé au plus simplifié
+//
+// Chaque tableau commence sur une frontière de MESH_FILE_ALIGNMENT octets.
+// sourceHash est le hachage FNV-1a du modèle source et de ses fichiers de
+// matériaux : s'il ne correspond plus, le fichier est recalculé.
+
+#define MESH_FILE_MAGIC "OGLB"
+#define MESH_FILE_VERSION 6
+#define MESH_FILE_ALIGNMENT 64
+// Extension ajoutée au chemin du modèle source
+#define MESH_FILE_EXTENSION ".mesh"
+// Nombre maximal de matériaux d'un modèle (palette du shader des voitures)
+#define MESH_MAX_MATERIALS 16
+
+// Format des sommets envoyés au GPU
+enum class MeshVertexFormat : uint32_t {
+    FLOAT, // Position, couleur, normale : 9 floats (36 octets)
+    PACKED // PackedModelVertex (12 octets)
+};
+
+// Sommet compressé : normale octaédrique, position quantifiée sur 16 bits
+// dans la boîte englobante du modèle, indice du matériau dans la palette
+struct PackedModelVertex {
+    int16_t normal[2];
+    uint16_t position[3];
+    uint8_t material;
+    uint8_t padding;
+};
+
+struct MeshFileHeader {
+    char magic[4]; // MESH_FILE_MAGIC
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t submeshCount;
+    uint32_t vertexFormat; // MeshVertexFormat
+    float boundsMin[3];    // Boîte englobante du modèle entier
+    float boundsMax[3];
+    uint32_t materialCount;
+    uint32_t indexSize; // Taille d'un indice en octets : 2 ou 4
+    uint64_t vertexOffset;   // Position des sommets dans le fichier
+    uint64_t indexOffset;    // Position des indices dans le fichier
+    uint64_t submeshOffset;  // Position de la table des sous-meshes
+    uint64_t materialOffset; // Position de la palette des matériaux
+    uint32_t lodCount;
+    uint32_t padding;
+    uint64_t lodOffset; // Position de la table des niveaux de détail
+};
+
+// Partie d'un modèle dessinée d'un seul appel : une plage de l'EBO, dont les
+// indices sont relatifs à baseVertex (glDrawElementsBaseVertex), et le
+// matériau de la partie
+struct SubMesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t baseVertex;
+    uint32_t material; // Indice du matériau dans le fichier source
+};
+
+// Niveau de détail d'un modèle : une plage de la table des sous-meshes.
+// Tous les niveaux partagent les sommets du niveau 0 ; seuls les indices
+// diffèrent.
+struct MeshLod {
+    uint32_t firstSubmesh;
+    uint32_t submeshCount;
+    float error; // Écart maximal avec le modèle complet (unités du modèle)
+    uint32_t padding;
+};
+
+static_assert(sizeof(MeshFileHeader) == 112, "En-tête de modèle mal aligné");
+static_assert(sizeof(PackedModelVertex) == 12, "Sommet compressé mal aligné");
+static_assert(sizeof(SubMesh) == 16, "Sous-mesh mal aligné");
+static_assert(sizeof(MeshLod) == 16, "Niveau de détail mal aligné");
+
+#endif
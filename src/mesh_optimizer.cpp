@@ -0,0 +1,376 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "hash.hpp"
+
+float computeAcmr(const uint32_t *indices, size_t indexCount,
+                  size_t vertexCount, int cacheSize) {
+    if (indexCount < 3) {
+        return 0.0f;
+    }
+    // Instant d'entrée de chaque sommet dans la file (0 : absent)
+    std::vector<size_t> enteredAt(vertexCount, 0);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        size_t &entered = enteredAt[indices[i]];
+        if (entered == 0 || misses - entered >= static_cast<size_t>(cacheSize)) {
+            misses++;
+            entered = misses;
+        }
+    }
+    return static_cast<float>(misses) / (indexCount / 3);
+}
+
+// Fusionner les sommets dont les MODEL_VERTEX_FLOATS floats sont identiques
+// (comparaison binaire) et réécrire les indices en conséquence
+static void weldVertices(const float *vertices, size_t vertexCount,
+                         std::vector<uint32_t> &indices,
+                         std::vector<float> &welded) {
+    struct VertexHash {
+        size_t operator()(const float *vertex) const {
+            return static_cast<size_t>(
+                fnv1a(vertex, MODEL_VERTEX_FLOATS * sizeof(float)));
+        }
+    };
+    struct VertexEqual {
+        bool operator()(const float *a, const float *b) const {
+            return std::memcmp(a, b, MODEL_VERTEX_FLOATS * sizeof(float)) == 0;
+        }
+    };
+    std::unordered_map<const float *, uint32_t, VertexHash, VertexEqual>
+        unique;
+    std::vector<uint32_t> remap(vertexCount);
+    welded.clear();
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float *vertex = vertices + i * MODEL_VERTEX_FLOATS;
+        auto inserted = unique.emplace(
+            vertex, static_cast<uint32_t>(welded.size() / MODEL_VERTEX_FLOATS));
+        if (inserted.second) {
+            welded.insert(welded.end(), vertex, vertex + MODEL_VERTEX_FLOATS);
+        }
+        remap[i] = inserted.first->second;
+    }
+    for (uint32_t &index : indices) {
+        index = remap[index];
+    }
+}
+
+// Score d'un sommet selon sa position dans le cache LRU simulé et le nombre
+// de triangles qui l'utilisent encore (T. Forsyth, "Linear-Speed Vertex
+// Cache Optimisation")
+static float forsythVertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f; // Plus aucun triangle : inutile
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Sommets du dernier triangle : score fixe, pour ne pas
+            // favoriser les bandes trop longues
+            score = 0.75f;
+        } else {
+            const float scale = 1.0f / (MESH_OPTIMIZER_LRU_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, 1.5f);
+        }
+    }
+    // Favoriser les sommets qui n'ont plus que quelques triangles
+    score += 2.0f * std::pow(static_cast<float>(remainingTriangles), -0.5f);
+    return score;
+}
+
+void optimizeVertexCache(std::vector<uint32_t> &indices,
+                         size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Triangles de chaque sommet
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    for (uint32_t index : indices) {
+        triangleOffsets[index + 1]++;
+    }
+    std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(),
+                     triangleOffsets.begin());
+    std::vector<uint32_t> vertexTriangles(indices.size());
+    std::vector<uint32_t> fill(triangleOffsets.begin(),
+                               triangleOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+        vertexTriangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int> remaining(vertexCount);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        remaining[v] = triangleOffsets[v + 1] - triangleOffsets[v];
+        vertexScores[v] = forsythVertexScore(-1, remaining[v]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = vertexScores[indices[3 * t]] +
+                            vertexScores[indices[3 * t + 1]] +
+                            vertexScores[indices[3 * t + 2]];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> ordered;
+    ordered.reserve(indices.size());
+    std::vector<uint32_t> cache, nextCache;
+    size_t scanCursor = 0;
+
+    for (size_t step = 0; step < triangleCount; step++) {
+        // Meilleur triangle parmi ceux des sommets en cache ; à défaut,
+        // premier triangle restant
+        int best = -1;
+        float bestScore = -1.0f;
+        for (uint32_t vertex : cache) {
+            for (uint32_t i = triangleOffsets[vertex];
+                 i < triangleOffsets[vertex + 1]; i++) {
+                uint32_t triangle = vertexTriangles[i];
+                if (!emitted[triangle] && triangleScores[triangle] > bestScore) {
+                    best = static_cast<int>(triangle);
+                    bestScore = triangleScores[triangle];
+                }
+            }
+        }
+        if (best < 0) {
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            best = static_cast<int>(scanCursor);
+        }
+
+        emitted[best] = true;
+        const uint32_t *corners = &indices[3 * best];
+        ordered.insert(ordered.end(), corners, corners + 3);
+
+        // Les sommets du triangle passent en tête du cache LRU
+        nextCache.assign(corners, corners + 3);
+        for (uint32_t vertex : cache) {
+            if (vertex != corners[0] && vertex != corners[1] &&
+                vertex != corners[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            remaining[corners[i]]--;
+        }
+        // Les sommets sortis du cache perdent leur bonus
+        for (size_t i = MESH_OPTIMIZER_LRU_SIZE; i < nextCache.size(); i++) {
+            vertexScores[nextCache[i]] =
+                forsythVertexScore(-1, remaining[nextCache[i]]);
+        }
+        if (nextCache.size() > MESH_OPTIMIZER_LRU_SIZE) {
+            nextCache.resize(MESH_OPTIMIZER_LRU_SIZE);
+        }
+        cache.swap(nextCache);
+
+        // Mettre à jour les scores des sommets en cache et de leurs
+        // triangles
+        for (size_t i = 0; i < cache.size(); i++) {
+            vertexScores[cache[i]] =
+                forsythVertexScore(static_cast<int>(i), remaining[cache[i]]);
+        }
+        for (uint32_t vertex : cache) {
+            for (uint32_t i = triangleOffsets[vertex];
+                 i < triangleOffsets[vertex + 1]; i++) {
+                uint32_t triangle = vertexTriangles[i];
+                triangleScores[triangle] =
+                    vertexScores[indices[3 * triangle]] +
+                    vertexScores[indices[3 * triangle + 1]] +
+                    vertexScores[indices[3 * triangle + 2]];
+            }
+        }
+    }
+    indices.swap(ordered);
+}
+
+// Réordonner des groupes de triangles contigus (coupés là où le cache est
+// entièrement manqué) pour dessiner d'abord les faces tournées vers
+// l'extérieur, qui cachent les autres depuis la plupart des points de vue
+// (P. Sander et al., "Fast Triangle Reordering for Vertex Locality and
+// Reduced Overdraw")
+static void optimizeOverdraw(std::vector<uint32_t> &indices,
+                             const std::vector<float> &vertices) {
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size() / MODEL_VERTEX_FLOATS;
+    if (triangleCount < 2) {
+        return;
+    }
+    auto position = [&](uint32_t vertex) {
+        const float *p = &vertices[vertex * MODEL_VERTEX_FLOATS];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // Découpage : un groupe commence à chaque triangle dont aucun sommet
+    // n'est dans le cache FIFO
+    std::vector<size_t> clusterStarts;
+    std::deque<uint32_t> fifo;
+    for (size_t t = 0; t < triangleCount; t++) {
+        int misses = 0;
+        for (int i = 0; i < 3; i++) {
+            uint32_t vertex = indices[3 * t + i];
+            if (std::find(fifo.begin(), fifo.end(), vertex) == fifo.end()) {
+                misses++;
+                fifo.push_back(vertex);
+                if (fifo.size() > MESH_OPTIMIZER_FIFO_SIZE) {
+                    fifo.pop_front();
+                }
+            }
+        }
+        if (misses == 3 || t == 0) {
+            clusterStarts.push_back(t);
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    const size_t clusterCount = clusterStarts.size() - 1;
+    if (clusterCount < 2) {
+        return;
+    }
+
+    // Centre du modèle, pondéré par l'aire
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCenters(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    std::vector<float> clusterAreas(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; c++) {
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            glm::vec3 a = position(indices[3 * t]);
+            glm::vec3 b = position(indices[3 * t + 1]);
+            glm::vec3 d = position(indices[3 * t + 2]);
+            glm::vec3 normal = glm::cross(b - a, d - a);
+            float area = glm::length(normal) * 0.5f;
+            glm::vec3 centroid = (a + b + d) / 3.0f;
+            clusterCenters[c] += centroid * area;
+            clusterNormals[c] += normal;
+            clusterAreas[c] += area;
+        }
+        meshCenter += clusterCenters[c];
+        meshArea += clusterAreas[c];
+    }
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    meshCenter /= meshArea;
+
+    // Plus un groupe est loin du centre dans la direction de sa normale,
+    // plus il est susceptible de cacher les autres
+    std::vector<float> occlusion(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; c++) {
+        if (clusterAreas[c] > 0.0f && glm::length(clusterNormals[c]) > 0.0f) {
+            glm::vec3 center = clusterCenters[c] / clusterAreas[c];
+            occlusion[c] =
+                glm::dot(center - meshCenter, glm::normalize(clusterNormals[c]));
+        }
+    }
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return occlusion[a] > occlusion[b];
+    });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (size_t c : order) {
+        sorted.insert(sorted.end(), indices.begin() + 3 * clusterStarts[c],
+                      indices.begin() + 3 * clusterStarts[c + 1]);
+    }
+
+    // Garder l'ordre du cache si le tri le dégrade trop
+    const float cacheAcmr =
+        computeAcmr(indices.data(), indices.size(), vertexCount);
+    const float sortedAcmr =
+        computeAcmr(sorted.data(), sorted.size(), vertexCount);
+    if (sortedAcmr <= cacheAcmr * MESH_OPTIMIZER_OVERDRAW_THRESHOLD) {
+        indices.swap(sorted);
+    }
+}
+
+// Renuméroter les sommets dans l'ordre de leur première utilisation
+static void optimizeVertexFetch(std::vector<uint32_t> &indices,
+                                std::vector<float> &vertices) {
+    const size_t vertexCount = vertices.size() / MODEL_VERTEX_FLOATS;
+    const uint32_t unused = UINT32_MAX;
+    std::vector<uint32_t> remap(vertexCount, unused);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+    for (uint32_t &index : indices) {
+        if (remap[index] == unused) {
+            remap[index] =
+                static_cast<uint32_t>(reordered.size() / MODEL_VERTEX_FLOATS);
+            const float *vertex = &vertices[index * MODEL_VERTEX_FLOATS];
+            reordered.insert(reordered.end(), vertex,
+                             vertex + MODEL_VERTEX_FLOATS);
+        }
+        index = remap[index];
+    }
+    // Les sommets qu'aucun triangle n'utilise sont abandonnés
+    vertices.swap(reordered);
+}
+
+void optimizeModel(ModelData &model) {
+    const size_t totalVertices = model.vertices.size() / MODEL_VERTEX_FLOATS;
+    ModelData optimized;
+    optimized.boundsMin = model.boundsMin;
+    optimized.boundsMax = model.boundsMax;
+    optimized.materialColors = model.materialColors;
+    // ACMR pondérés par le nombre de triangles : importé, soudé, optimisé
+    float acmrBefore = 0.0f, acmrWelded = 0.0f, acmrAfter = 0.0f;
+
+    for (size_t s = 0; s < model.submeshes.size(); s++) {
+        const SubMesh &submesh = model.submeshes[s];
+        // Les sommets d'un sous-mesh vont jusqu'au début du suivant
+        const size_t firstVertex = submesh.baseVertex;
+        const size_t endVertex = s + 1 < model.submeshes.size()
+                                     ? model.submeshes[s + 1].baseVertex
+                                     : totalVertices;
+        std::vector<uint32_t> indices(
+            model.indices.begin() + submesh.firstIndex,
+            model.indices.begin() + submesh.firstIndex + submesh.indexCount);
+        acmrBefore += computeAcmr(indices.data(), indices.size(),
+                                  endVertex - firstVertex) *
+                      (indices.size() / 3);
+
+        std::vector<float> vertices;
+        weldVertices(&model.vertices[firstVertex * MODEL_VERTEX_FLOATS],
+                     endVertex - firstVertex, indices, vertices);
+        acmrWelded += computeAcmr(indices.data(), indices.size(),
+                                  vertices.size() / MODEL_VERTEX_FLOATS) *
+                      (indices.size() / 3);
+        optimizeVertexCache(indices, vertices.size() / MODEL_VERTEX_FLOATS);
+        optimizeOverdraw(indices, vertices);
+        optimizeVertexFetch(indices, vertices);
+        acmrAfter += computeAcmr(indices.data(), indices.size(),
+                                 vertices.size() / MODEL_VERTEX_FLOATS) *
+                     (indices.size() / 3);
+
+        SubMesh result = submesh;
+        result.firstIndex = static_cast<uint32_t>(optimized.indices.size());
+        result.baseVertex = static_cast<int32_t>(optimized.vertices.size() /
+                                                 MODEL_VERTEX_FLOATS);
+        optimized.submeshes.push_back(result);
+        optimized.indices.insert(optimized.indices.end(), indices.begin(),
+                                 indices.end());
+        optimized.vertices.insert(optimized.vertices.end(), vertices.begin(),
+                                  vertices.end());
+    }
+
+    const size_t triangleCount = model.indices.size() / 3;
+    if (triangleCount > 0) {
+        std::cout << "Modèle optimisé : " << totalVertices << " -> "
+                  << optimized.vertices.size() / MODEL_VERTEX_FLOATS
+                  << " sommets, ACMR " << acmrBefore / triangleCount
+                  << " -> " << acmrWelded / triangleCount << " (soudé) -> "
+                  << acmrAfter / triangleCount << std::endl;
+    }
+    model = std::move(optimized);
+}
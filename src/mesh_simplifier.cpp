@@ -0,0 +1,446 @@
+#include "mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "hash.hpp"
+#include "mesh_optimizer.hpp"
+
+// Quadrique d'erreur : somme pondérée des carrés des distances à des plans,
+// gardée sous forme de matrice symétrique 4x4 (10 coefficients : xx xy xz
+// xw yy yz yw zz zw ww) avec la somme des poids
+struct Quadric {
+    double a[10];
+    double weight;
+};
+
+static Quadric planeQuadric(const glm::dvec3 &normal, double distance,
+                            double weight) {
+    const double n[4] = {normal.x, normal.y, normal.z, distance};
+    Quadric quadric;
+    int k = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = i; j < 4; j++) {
+            quadric.a[k++] = n[i] * n[j] * weight;
+        }
+    }
+    quadric.weight = weight;
+    return quadric;
+}
+
+static void addQuadric(Quadric &quadric, const Quadric &other) {
+    for (int i = 0; i < 10; i++) {
+        quadric.a[i] += other.a[i];
+    }
+    quadric.weight += other.weight;
+}
+
+// Carré moyen de la distance de point aux plans de la quadrique
+static double quadricError(const Quadric &quadric, const glm::dvec3 &point) {
+    const double *a = quadric.a;
+    const double x = point.x, y = point.y, z = point.z;
+    const double error = a[0] * x * x + 2.0 * a[1] * x * y +
+                         2.0 * a[2] * x * z + 2.0 * a[3] * x + a[4] * y * y +
+                         2.0 * a[5] * y * z + 2.0 * a[6] * y + a[7] * z * z +
+                         2.0 * a[8] * z + a[9];
+    return quadric.weight > 0.0 ? std::max(error, 0.0) / quadric.weight : 0.0;
+}
+
+// Simplification d'un sous-mesh. Les arêtes sont effondrées entre positions
+// (les sommets de même position, séparés par une couture, restent
+// ensemble) ; les triangles gardent leurs sommets d'origine, remplacés à la
+// sortie par un sommet de la position qui a survécu.
+class SubmeshSimplifier {
+  public:
+    SubmeshSimplifier(const float *vertices, size_t vertexCount,
+                      const uint32_t *indices, size_t indexCount)
+        : vertices(vertices), corners(indices, indices + indexCount),
+          removedTriangles(indexCount / 3, false),
+          triangleCount(indexCount / 3), maxError(0.0) {
+        groupPositions(vertexCount);
+        computeQuadrics();
+
+        // Toutes les arêtes, dans les deux sens
+        for (size_t t = 0; t < removedTriangles.size(); t++) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            uint32_t p[3];
+            trianglePositions(t, p);
+            for (int i = 0; i < 3; i++) {
+                pushCollapse(p[i], p[(i + 1) % 3]);
+                pushCollapse(p[(i + 1) % 3], p[i]);
+            }
+        }
+    }
+
+    // Effondrer les arêtes les moins coûteuses jusqu'à ne garder que
+    // targetTriangles triangles (ou jusqu'à ne plus en trouver)
+    void simplify(size_t targetTriangles) {
+        while (triangleCount > targetTriangles && !queue.empty()) {
+            const Collapse collapse = queue.top();
+            queue.pop();
+            if (resolve(collapse.from) != collapse.from ||
+                resolve(collapse.to) != collapse.to ||
+                versions[collapse.from] != collapse.fromVersion ||
+                versions[collapse.to] != collapse.toVersion ||
+                !canCollapse(collapse.from, collapse.to)) {
+                continue; // Arête périmée ou qui retournerait un triangle
+            }
+            collapsePosition(collapse.from, collapse.to);
+            maxError = std::max(maxError, collapse.cost);
+        }
+    }
+
+    size_t getTriangleCount() const { return triangleCount; }
+
+    // Plus grand écart (en unités du modèle) commis jusqu'ici
+    float getError() const { return static_cast<float>(std::sqrt(maxError)); }
+
+    // Indices des triangles restants, relatifs au sous-mesh
+    std::vector<uint32_t> getIndices() {
+        std::vector<uint32_t> indices;
+        indices.reserve(triangleCount * 3);
+        for (size_t t = 0; t < removedTriangles.size(); t++) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            for (int i = 0; i < 3; i++) {
+                indices.push_back(survivingVertex(corners[t * 3 + i]));
+            }
+        }
+        return indices;
+    }
+
+  private:
+    struct Collapse {
+        double cost;
+        uint32_t from, to; // Positions
+        uint32_t fromVersion, toVersion;
+        bool operator>(const Collapse &other) const {
+            return cost > other.cost;
+        }
+    };
+
+    const float *vertices;
+    std::vector<uint32_t> corners; // Sommets d'origine des triangles
+    std::vector<bool> removedTriangles;
+    size_t triangleCount; // Triangles restants
+    double maxError;      // Carré de l'écart maximal
+
+    std::vector<uint32_t> vertexPositions;   // Position de chaque sommet
+    std::vector<glm::dvec3> positions;
+    std::vector<std::vector<uint32_t>> positionVertices;
+    std::vector<std::vector<uint32_t>> positionTriangles;
+    // Position qui remplace chaque position (elle-même si elle survit)
+    std::vector<uint32_t> replacements;
+    std::vector<uint32_t> versions; // Incrémentée quand la quadrique change
+    std::vector<Quadric> quadrics;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+        queue;
+
+    // Regrouper les sommets de même position (comparaison binaire)
+    void groupPositions(size_t vertexCount) {
+        struct PositionHash {
+            size_t operator()(const float *position) const {
+                return static_cast<size_t>(
+                    fnv1a(position, 3 * sizeof(float)));
+            }
+        };
+        struct PositionEqual {
+            bool operator()(const float *a, const float *b) const {
+                return std::memcmp(a, b, 3 * sizeof(float)) == 0;
+            }
+        };
+        std::unordered_map<const float *, uint32_t, PositionHash,
+                           PositionEqual>
+            positionIndices;
+        vertexPositions.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            const float *vertex = vertices + v * MODEL_VERTEX_FLOATS;
+            auto inserted = positionIndices.emplace(
+                vertex, static_cast<uint32_t>(positions.size()));
+            if (inserted.second) {
+                positions.push_back(glm::dvec3(vertex[0], vertex[1], vertex[2]));
+                positionVertices.emplace_back();
+            }
+            vertexPositions[v] = inserted.first->second;
+            positionVertices[inserted.first->second].push_back(
+                static_cast<uint32_t>(v));
+        }
+        positionTriangles.resize(positions.size());
+        replacements.resize(positions.size());
+        for (size_t p = 0; p < positions.size(); p++) {
+            replacements[p] = static_cast<uint32_t>(p);
+        }
+        versions.assign(positions.size(), 0);
+    }
+
+    // Quadriques des plans des triangles (pondérés par leur aire) et des
+    // bords ouverts (plans perpendiculaires aux triangles, le long du bord)
+    void computeQuadrics() {
+        quadrics.assign(positions.size(), Quadric());
+        std::unordered_map<uint64_t, int> edgeTriangles;
+        auto edgeKey = [](uint32_t a, uint32_t b) {
+            return (static_cast<uint64_t>(std::min(a, b)) << 32) |
+                   std::max(a, b);
+        };
+        for (size_t t = 0; t < removedTriangles.size(); t++) {
+            uint32_t p[3];
+            trianglePositions(t, p);
+            if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2]) {
+                removedTriangles[t] = true; // Dégénéré dès l'import
+                continue;
+            }
+            glm::dvec3 normal = glm::cross(positions[p[1]] - positions[p[0]],
+                                           positions[p[2]] - positions[p[0]]);
+            const double length = glm::length(normal);
+            if (length > 0.0) {
+                normal /= length;
+            }
+            const Quadric plane = planeQuadric(
+                normal, -glm::dot(normal, positions[p[0]]), 0.5 * length);
+            for (int i = 0; i < 3; i++) {
+                addQuadric(quadrics[p[i]], plane);
+                positionTriangles[p[i]].push_back(static_cast<uint32_t>(t));
+                edgeTriangles[edgeKey(p[i], p[(i + 1) % 3])]++;
+            }
+        }
+        triangleCount = std::count(removedTriangles.begin(),
+                                   removedTriangles.end(), false);
+
+        for (size_t t = 0; t < removedTriangles.size(); t++) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            uint32_t p[3];
+            trianglePositions(t, p);
+            const glm::dvec3 faceNormal =
+                glm::cross(positions[p[1]] - positions[p[0]],
+                           positions[p[2]] - positions[p[0]]);
+            for (int i = 0; i < 3; i++) {
+                const uint32_t a = p[i], b = p[(i + 1) % 3];
+                if (edgeTriangles[edgeKey(a, b)] != 1) {
+                    continue;
+                }
+                const glm::dvec3 edge = positions[b] - positions[a];
+                glm::dvec3 normal = glm::cross(edge, faceNormal);
+                const double length = glm::length(normal);
+                if (length == 0.0) {
+                    continue;
+                }
+                normal /= length;
+                const Quadric border = planeQuadric(
+                    normal, -glm::dot(normal, positions[a]),
+                    glm::dot(edge, edge) * MESH_LOD_BORDER_WEIGHT);
+                addQuadric(quadrics[a], border);
+                addQuadric(quadrics[b], border);
+            }
+        }
+    }
+
+    uint32_t resolve(uint32_t position) {
+        uint32_t root = position;
+        while (replacements[root] != root) {
+            root = replacements[root];
+        }
+        // Raccourcir le chemin pour les prochaines recherches
+        while (replacements[position] != root) {
+            const uint32_t next = replacements[position];
+            replacements[position] = root;
+            position = next;
+        }
+        return root;
+    }
+
+    void trianglePositions(size_t triangle, uint32_t p[3]) {
+        for (int i = 0; i < 3; i++) {
+            p[i] = resolve(vertexPositions[corners[triangle * 3 + i]]);
+        }
+    }
+
+    void pushCollapse(uint32_t from, uint32_t to) {
+        Quadric quadric = quadrics[from];
+        addQuadric(quadric, quadrics[to]);
+        queue.push({quadricError(quadric, positions[to]), from, to,
+                    versions[from], versions[to]});
+    }
+
+    // Ramener from sur to ne doit retourner ni écraser aucun triangle
+    // restant
+    bool canCollapse(uint32_t from, uint32_t to) {
+        for (uint32_t t : positionTriangles[from]) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            uint32_t p[3];
+            trianglePositions(t, p);
+            if (p[0] == to || p[1] == to || p[2] == to) {
+                continue; // Disparaît avec l'arête
+            }
+            const glm::dvec3 before =
+                glm::cross(positions[p[1]] - positions[p[0]],
+                           positions[p[2]] - positions[p[0]]);
+            for (int i = 0; i < 3; i++) {
+                if (p[i] == from) {
+                    p[i] = to;
+                }
+            }
+            const glm::dvec3 after =
+                glm::cross(positions[p[1]] - positions[p[0]],
+                           positions[p[2]] - positions[p[0]]);
+            const double lengths = glm::length(before) * glm::length(after);
+            if (lengths <= 0.0 || glm::dot(before, after) < 0.25 * lengths) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void collapsePosition(uint32_t from, uint32_t to) {
+        replacements[from] = to;
+        addQuadric(quadrics[to], quadrics[from]);
+        versions[to]++;
+
+        std::vector<uint32_t> &triangles = positionTriangles[to];
+        for (uint32_t t : positionTriangles[from]) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            uint32_t p[3];
+            trianglePositions(t, p);
+            if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2]) {
+                removedTriangles[t] = true;
+                triangleCount--;
+            } else {
+                triangles.push_back(t);
+            }
+        }
+        std::vector<uint32_t>().swap(positionTriangles[from]);
+
+        // Garder les triangles restants et recalculer le coût des arêtes
+        // qui touchent to
+        triangles.erase(std::remove_if(triangles.begin(), triangles.end(),
+                                       [&](uint32_t t) {
+                                           return removedTriangles[t];
+                                       }),
+                        triangles.end());
+        for (uint32_t t : triangles) {
+            uint32_t p[3];
+            trianglePositions(t, p);
+            for (int i = 0; i < 3; i++) {
+                if (p[i] != to) {
+                    pushCollapse(to, p[i]);
+                    pushCollapse(p[i], to);
+                }
+            }
+        }
+    }
+
+    // Sommet qui remplace vertex : lui-même si sa position a survécu, sinon
+    // le sommet de la position survivante dont la couleur et la normale
+    // sont les plus proches
+    uint32_t survivingVertex(uint32_t vertex) {
+        const uint32_t position = resolve(vertexPositions[vertex]);
+        if (position == vertexPositions[vertex]) {
+            return vertex;
+        }
+        const float *original = vertices + vertex * MODEL_VERTEX_FLOATS;
+        uint32_t best = positionVertices[position][0];
+        float bestScore = -1e30f;
+        for (uint32_t candidate : positionVertices[position]) {
+            const float *other = vertices + candidate * MODEL_VERTEX_FLOATS;
+            const bool sameColor =
+                std::memcmp(original + 3, other + 3, 3 * sizeof(float)) == 0;
+            const float score = (sameColor ? 2.0f : 0.0f) +
+                                original[6] * other[6] +
+                                original[7] * other[7] + original[8] * other[8];
+            if (score > bestScore) {
+                bestScore = score;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+};
+
+void buildModelLods(ModelData &model, int lodCount) {
+    const size_t totalVertices = model.vertices.size() / MODEL_VERTEX_FLOATS;
+    // Repartir du seul niveau 0
+    const size_t baseSubmeshCount =
+        model.lods.empty() ? model.submeshes.size()
+                           : model.lods[0].submeshCount;
+    model.submeshes.resize(baseSubmeshCount);
+    size_t baseIndexCount = 0;
+    for (const SubMesh &submesh : model.submeshes) {
+        baseIndexCount = std::max<size_t>(
+            baseIndexCount, submesh.firstIndex + submesh.indexCount);
+    }
+    model.indices.resize(baseIndexCount);
+    model.lods.assign(
+        1, MeshLod{0, static_cast<uint32_t>(baseSubmeshCount), 0.0f, 0});
+
+    // Les sommets d'un sous-mesh vont jusqu'au début du suivant
+    std::vector<SubmeshSimplifier> simplifiers;
+    std::vector<size_t> vertexCounts;
+    for (size_t s = 0; s < baseSubmeshCount; s++) {
+        const SubMesh &submesh = model.submeshes[s];
+        const size_t endVertex = s + 1 < baseSubmeshCount
+                                     ? model.submeshes[s + 1].baseVertex
+                                     : totalVertices;
+        vertexCounts.push_back(endVertex - submesh.baseVertex);
+        simplifiers.emplace_back(
+            model.vertices.data() +
+                static_cast<size_t>(submesh.baseVertex) * MODEL_VERTEX_FLOATS,
+            vertexCounts.back(), model.indices.data() + submesh.firstIndex,
+            submesh.indexCount);
+    }
+
+    std::vector<size_t> triangleCounts(1, baseIndexCount / 3);
+    for (int lod = 1; lod < lodCount; lod++) {
+        const size_t submeshCount = model.submeshes.size();
+        const size_t indexCount = model.indices.size();
+        MeshLod level = {static_cast<uint32_t>(submeshCount),
+                         static_cast<uint32_t>(baseSubmeshCount), 0.0f, 0};
+        size_t levelTriangles = 0;
+        for (size_t s = 0; s < baseSubmeshCount; s++) {
+            const size_t target = static_cast<size_t>(
+                model.submeshes[s].indexCount / 3 *
+                std::pow(MESH_LOD_REDUCTION, static_cast<float>(lod)));
+            simplifiers[s].simplify(target);
+            std::vector<uint32_t> indices = simplifiers[s].getIndices();
+            optimizeVertexCache(indices, vertexCounts[s]);
+
+            SubMesh submesh = model.submeshes[s];
+            submesh.firstIndex = static_cast<uint32_t>(model.indices.size());
+            submesh.indexCount = static_cast<uint32_t>(indices.size());
+            model.submeshes.push_back(submesh);
+            model.indices.insert(model.indices.end(), indices.begin(),
+                                 indices.end());
+            level.error = std::max(level.error, simplifiers[s].getError());
+            levelTriangles += indices.size() / 3;
+        }
+
+        // Plus rien à simplifier : le niveau serait identique au précédent
+        if (levelTriangles >= triangleCounts.back()) {
+            model.submeshes.resize(submeshCount);
+            model.indices.resize(indexCount);
+            break;
+        }
+        model.lods.push_back(level);
+        triangleCounts.push_back(levelTriangles);
+    }
+
+    std::cout << "Niveaux de détail :";
+    for (size_t lod = 0; lod < triangleCounts.size(); lod++) {
+        std::cout << (lod == 0 ? " " : " -> ") << triangleCounts[lod];
+    }
+    std::cout << " triangles, écart maximal " << model.lods.back().error
+              << std::endl;
+}
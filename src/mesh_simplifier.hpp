@@ -0,0 +1,23 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "model_loader.hpp"
+
+// Nombre de niveaux de détail d'un modèle, le niveau 0 compris
+#define MESH_LOD_COUNT 4
+// Fraction des triangles gardée d'un niveau au suivant
+#define MESH_LOD_REDUCTION 0.5f
+// Poids des plans qui retiennent les bords ouverts du modèle
+#define MESH_LOD_BORDER_WEIGHT 10.0f
+
+// Ajouter à un modèle optimisé (voir optimizeModel) ses niveaux de détail
+// simplifiés, par effondrement d'arêtes guidé par les quadriques d'erreur
+// (Garland et Heckbert). Chaque arête est ramenée sur l'une de ses
+// extrémités : aucun sommet n'est créé et tous les niveaux partagent le
+// tampon de sommets ; chaque niveau ajoute ses indices et un sous-mesh par
+// sous-mesh du niveau 0. Les sommets qui partagent une position (coutures
+// de normales ou de couleurs) sont simplifiés ensemble, pour ne pas ouvrir
+// de fissure. L'erreur de chaque niveau est enregistrée dans model.lods.
+void buildModelLods(ModelData &model, int lodCount = MESH_LOD_COUNT);
+
+#endif
@@ -0,0 +1,581 @@
+#include "model_loader.hpp"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#include "binary_writer.hpp"
+#include "hash.hpp"
+#include "mesh_file.hpp"
+#include "vertex_packing.hpp"
+#include "virtual_file_system.hpp"
+
+// Fichier lu par Assimp à travers VirtualFileSystem
+class VirtualIOStream : public Assimp::IOStream {
+  public:
+    explicit VirtualIOStream(FileData &&file)
+        : file(std::move(file)), position(0) {}
+
+    size_t Read(void *buffer, size_t size, size_t count) override {
+        if (size == 0) {
+            return 0;
+        }
+        // Éléments complets seulement
+        count = std::min(count, (file.size() - position) / size);
+        std::copy(file.data() + position, file.data() + position + size * count,
+                  static_cast<unsigned char *>(buffer));
+        position += size * count;
+        return count;
+    }
+    size_t Write(const void *, size_t, size_t) override { return 0; }
+    aiReturn Seek(size_t offset, aiOrigin origin) override {
+        const size_t base = origin == aiOrigin_SET   ? 0
+                            : origin == aiOrigin_CUR ? position
+                                                     : file.size();
+        if (offset > file.size() - base) {
+            return aiReturn_FAILURE;
+        }
+        position = base + offset;
+        return aiReturn_SUCCESS;
+    }
+    size_t Tell() const override { return position; }
+    size_t FileSize() const override { return file.size(); }
+    void Flush() override {}
+
+  private:
+    FileData file;
+    size_t position;
+};
+
+// Système de fichiers d'Assimp : le modèle et ses matériaux sont lus dans
+// les archives montées, sinon sur le disque
+class VirtualIOSystem : public Assimp::IOSystem {
+  public:
+    bool Exists(const char *path) const override {
+        return VirtualFileSystem::get().exists(path);
+    }
+    char getOsSeparator() const override { return '/'; }
+    Assimp::IOStream *Open(const char *path, const char *mode) override {
+        if (std::string(mode).find_first_of("wa+") != std::string::npos) {
+            return nullptr; // Lecture seule
+        }
+        FileData file;
+        if (!VirtualFileSystem::get().read(path, file)) {
+            return nullptr;
+        }
+        return new VirtualIOStream(std::move(file));
+    }
+    void Close(Assimp::IOStream *stream) override { delete stream; }
+};
+
+// Fonction de traitement d'un mesh
+static void processMesh(aiMesh *mesh, const aiScene *scene, ModelData &model) {
+    // Vérifier s'il y a un matériau assigné à ce mesh
+    aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+
+    // Extraire la couleur diffuse (qui est souvent la couleur principale de l'objet)
+    aiColor4D diffuseColor(1.0f, 0.0f, 0.0f, 1.0f); // Par défaut, rouge
+    aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuseColor);
+
+    // Les sommets du mesh suivent ceux des meshes précédents : ses indices
+    // restent locaux, décalés au dessin par baseVertex
+    SubMesh submesh;
+    submesh.firstIndex = static_cast<uint32_t>(model.indices.size());
+    submesh.baseVertex =
+        static_cast<int32_t>(model.vertices.size() / MODEL_VERTEX_FLOATS);
+    submesh.material = mesh->mMaterialIndex;
+
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+        aiVector3D position = mesh->mVertices[i];
+        glm::vec3 point(position.x, position.y, position.z);
+        if (model.vertices.empty()) {
+            model.boundsMin = model.boundsMax = point;
+        }
+        model.boundsMin = glm::min(model.boundsMin, point);
+        model.boundsMax = glm::max(model.boundsMax, point);
+        // Initialiser la normale à zéro
+        glm::vec3 normal(0.0f);
+
+        if (mesh->HasNormals()) {
+            // Si les normales existent, les récupérer
+            aiVector3D aiNormal = mesh->mNormals[i];
+            normal = glm::vec3(aiNormal.x, aiNormal.y, aiNormal.z);
+        }
+
+        // Ajouter la position, la couleur et la normale
+        model.vertices.insert(model.vertices.end(),
+                              {position.x, position.y, position.z,
+                               diffuseColor.r, diffuseColor.g, diffuseColor.b,
+                               normal.x, normal.y, normal.z});
+    }
+
+    // Extraire les indices
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+        aiFace face = mesh->mFaces[i];
+        for (unsigned int j = 0; j < face.mNumIndices; j++) {
+            model.indices.push_back(face.mIndices[j]);
+        }
+    }
+    submesh.indexCount =
+        static_cast<uint32_t>(model.indices.size()) - submesh.firstIndex;
+    model.submeshes.push_back(submesh);
+}
+
+// Fonction de traitement des nodes et des meshes
+static void processNode(aiNode *node, const aiScene *scene, ModelData &model) {
+    // Traiter chaque mesh du node
+    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+        processMesh(mesh, scene, model);
+    }
+
+    // Traiter les enfants du node
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        processNode(node->mChildren[i], scene, model);
+    }
+}
+
+bool loadModelData(const std::string &path, ModelData &model) {
+    // Importer le modèle avec Assimp en forçant la triangulation des faces
+    Assimp::Importer importer;
+    importer.SetIOHandler(new VirtualIOSystem()); // Libéré par l'importeur
+    const aiScene *scene =
+        importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+
+    if (!scene || !scene->mRootNode) {
+        std::cerr << "Erreur lors du chargement du modèle: " << path
+                  << std::endl;
+        return false;
+    }
+
+    // Extraire les données des vertices et indices
+    model = ModelData();
+    model.boundsMin = model.boundsMax = glm::vec3(0.0f);
+    processNode(scene->mRootNode, scene, model);
+
+    // Palette : couleur diffuse de chaque matériau
+    for (unsigned int i = 0;
+         i < scene->mNumMaterials && i < MESH_MAX_MATERIALS; i++) {
+        aiColor4D diffuseColor(1.0f, 0.0f, 0.0f, 1.0f); // Par défaut, rouge
+        aiGetMaterialColor(scene->mMaterials[i], AI_MATKEY_COLOR_DIFFUSE,
+                           &diffuseColor);
+        model.materialColors.push_back(
+            glm::vec3(diffuseColor.r, diffuseColor.g, diffuseColor.b));
+    }
+    return true;
+}
+
+// Tableaux d'un modèle prêts pour le GPU, où qu'ils soient (modèle importé
+// ou fichier projeté)
+struct MeshArrays {
+    MeshVertexFormat format;
+    const void *vertices;
+    size_t vertexCount;
+    const void *indices;
+    size_t indexCount;
+    size_t indexSize; // 2 (GL_UNSIGNED_SHORT) ou 4 (GL_UNSIGNED_INT) octets
+    const SubMesh *submeshes;
+    size_t submeshCount;
+    const float *materialColors; // 3 floats par matériau
+    size_t materialCount;
+    const MeshLod *lods;
+    size_t lodCount;
+    glm::vec3 boundsMin, boundsMax;
+};
+
+static size_t vertexSize(MeshVertexFormat format) {
+    return format == MeshVertexFormat::PACKED
+               ? sizeof(PackedModelVertex)
+               : MODEL_VERTEX_FLOATS * sizeof(float);
+}
+
+// Tableaux convertis par modelArrays, qui doivent vivre aussi longtemps que
+// les MeshArrays qui les désignent
+struct ConvertedArrays {
+    std::vector<PackedModelVertex> vertices;
+    std::vector<uint16_t> indices;
+    MeshLod singleLod;
+};
+
+// Tableaux d'un modèle importé dans le format demandé. Les indices sont
+// relatifs au sous-mesh : s'ils tiennent tous sur 16 bits, ils sont écrits
+// sur 16 bits. Les tableaux convertis sont écrits dans converted.
+static MeshArrays modelArrays(const ModelData &model, MeshVertexFormat format,
+                              ConvertedArrays &converted) {
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "");
+    MeshArrays arrays;
+    arrays.format = format;
+    arrays.vertexCount = model.vertices.size() / MODEL_VERTEX_FLOATS;
+    arrays.vertices = model.vertices.data();
+    arrays.indices = model.indices.data();
+    arrays.indexCount = model.indices.size();
+    arrays.indexSize = sizeof(uint32_t);
+    arrays.submeshes = model.submeshes.data();
+    arrays.submeshCount = model.submeshes.size();
+    arrays.materialColors =
+        reinterpret_cast<const float *>(model.materialColors.data());
+    arrays.materialCount = model.materialColors.size();
+    // Sans niveaux de détail, un seul niveau fait de tous les sous-meshes
+    converted.singleLod = {0, static_cast<uint32_t>(model.submeshes.size()),
+                           0.0f, 0};
+    arrays.lods = model.lods.empty() ? &converted.singleLod : model.lods.data();
+    arrays.lodCount = model.lods.empty() ? 1 : model.lods.size();
+    arrays.boundsMin = model.boundsMin;
+    arrays.boundsMax = model.boundsMax;
+
+    const bool shortIndices =
+        std::all_of(model.indices.begin(), model.indices.end(),
+                    [](unsigned int index) { return index <= UINT16_MAX; });
+    if (shortIndices) {
+        converted.indices.assign(model.indices.begin(), model.indices.end());
+        arrays.indices = converted.indices.data();
+        arrays.indexSize = sizeof(uint16_t);
+    }
+    if (format != MeshVertexFormat::PACKED) {
+        return arrays;
+    }
+
+    // Positions quantifiées dans la boîte englobante, normales
+    // octaédriques, matériau du sous-mesh. Seuls les sous-meshes du niveau
+    // de détail 0 possèdent des sommets.
+    const glm::vec3 scale = (model.boundsMax - model.boundsMin) / 65535.0f;
+    std::vector<PackedModelVertex> &packed = converted.vertices;
+    packed.assign(arrays.vertexCount, PackedModelVertex());
+    const size_t baseSubmeshCount = arrays.lods[0].submeshCount;
+    for (size_t s = 0; s < baseSubmeshCount; s++) {
+        const size_t first = model.submeshes[s].baseVertex;
+        const size_t end = s + 1 < baseSubmeshCount
+                               ? model.submeshes[s + 1].baseVertex
+                               : arrays.vertexCount;
+        // Toujours dans la palette si le format vient de modelVertexFormat
+        const uint8_t material = static_cast<uint8_t>(std::min<uint32_t>(
+            model.submeshes[s].material, MESH_MAX_MATERIALS - 1));
+        for (size_t v = first; v < end; v++) {
+            const float *vertex = &model.vertices[v * MODEL_VERTEX_FLOATS];
+            PackedModelVertex &out = packed[v];
+            for (int axis = 0; axis < 3; axis++) {
+                out.position[axis] = quantizeUint16(
+                    vertex[axis], model.boundsMin[axis], scale[axis]);
+            }
+            packOctahedralNormal(glm::vec3(vertex[6], vertex[7], vertex[8]),
+                                 out.normal);
+            out.material = material;
+        }
+    }
+    arrays.vertices = packed.data();
+    return arrays;
+}
+
+// Créer le VAO, le VBO et l'EBO d'un modèle dans mesh
+static void uploadMeshArrays(const MeshArrays &arrays, Mesh &mesh) {
+    mesh.format = arrays.format;
+    mesh.indexType = arrays.indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT
+                                                          : GL_UNSIGNED_INT;
+    mesh.submeshes.assign(arrays.submeshes,
+                          arrays.submeshes + arrays.submeshCount);
+    for (size_t i = 0; i < arrays.materialCount; i++) {
+        const float *color = arrays.materialColors + 3 * i;
+        mesh.materialColors.push_back(glm::vec3(color[0], color[1], color[2]));
+    }
+    mesh.lods.assign(arrays.lods, arrays.lods + arrays.lodCount);
+    mesh.boundsMin = arrays.boundsMin;
+    mesh.boundsMax = arrays.boundsMax;
+    mesh.center = (arrays.boundsMin + arrays.boundsMax) * 0.5f;
+
+    // Créer les buffers pour les données des vertices et indices
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(1, &mesh.vbo);
+    glGenBuffers(1, &mesh.ebo);
+
+    // Lier le VAO
+    glBindVertexArray(mesh.vao);
+
+    // Lier et charger les données du VBO
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 arrays.vertexCount * vertexSize(arrays.format),
+                 arrays.vertices, GL_STATIC_DRAW);
+
+    // Lier et charger les indices dans l'EBO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, arrays.indexCount * arrays.indexSize,
+                 arrays.indices, GL_STATIC_DRAW);
+
+    if (arrays.format == MeshVertexFormat::PACKED) {
+        const GLsizei stride = sizeof(PackedModelVertex);
+        // Position : entiers de 16 bits, remis à l'échelle par le shader
+        glVertexAttribPointer(
+            0, 3, GL_UNSIGNED_SHORT, GL_FALSE, stride,
+            (void *)offsetof(PackedModelVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // Normale octaédrique, lue dans [-1, 1]
+        glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, stride,
+                              (void *)offsetof(PackedModelVertex, normal));
+        glEnableVertexAttribArray(2);
+
+        // Indice du matériau (entier)
+        glVertexAttribIPointer(3, 1, GL_UNSIGNED_BYTE, stride,
+                               (void *)offsetof(PackedModelVertex, material));
+        glEnableVertexAttribArray(3);
+    } else {
+        const GLsizei stride = MODEL_VERTEX_FLOATS * sizeof(float);
+        // Définir les attributs des sommets (Position)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
+        glEnableVertexAttribArray(0);
+
+        // Définir les attributs des sommets (Couleur)
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride,
+                              (void *)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        // Définir les attributs des sommets (Normale)
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride,
+                              (void *)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+    }
+
+    // Dé-lier le VAO
+    glBindVertexArray(0);
+}
+
+// Modèle préparé : ses tableaux désignent le modèle importé et ses
+// conversions, ou les pages du fichier précalculé projeté
+struct PreparedMesh {
+    MeshArrays arrays;
+    ModelData model;
+    ConvertedArrays converted;
+    FileData file;
+};
+
+std::shared_ptr<PreparedMesh> prepareMesh(ModelData model,
+                                          MeshVertexFormat format) {
+    // Alloué avant de calculer les tableaux : ils pointent dans prepared
+    auto prepared = std::make_shared<PreparedMesh>();
+    prepared->model = std::move(model);
+    prepared->arrays =
+        modelArrays(prepared->model, format, prepared->converted);
+    return prepared;
+}
+
+void uploadPreparedMesh(const PreparedMesh &prepared, Mesh &mesh) {
+    uploadMeshArrays(prepared.arrays, mesh);
+}
+
+MeshVertexFormat modelVertexFormat(const std::string &path,
+                                   const ModelData &model,
+                                   MeshVertexFormat format) {
+    if (format != MeshVertexFormat::PACKED) {
+        return format;
+    }
+    for (const SubMesh &submesh : model.submeshes) {
+        if (submesh.material >= MESH_MAX_MATERIALS) {
+            std::cerr << "Attention : Plus de " << MESH_MAX_MATERIALS
+                      << " matériaux, sommets non compressés : " << path
+                      << std::endl;
+            return MeshVertexFormat::FLOAT;
+        }
+    }
+    return format;
+}
+
+bool hashModelSources(const std::string &path, uint64_t &hash) {
+    const VirtualFileSystem &fileSystem = VirtualFileSystem::get();
+    FileData file;
+    if (!fileSystem.read(path, file)) {
+        return false;
+    }
+    const std::string source(reinterpret_cast<const char *>(file.data()),
+                             file.size());
+    hash = fnv1a(source.data(), source.size());
+
+    // Les matériaux sont cherchés à côté du modèle. Un fichier cité mais
+    // absent compte par son seul nom (Assimp l'ignore aussi).
+    const std::filesystem::path directory =
+        std::filesystem::path(path).parent_path();
+    std::istringstream lines(source);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream words(line);
+        std::string keyword, library;
+        words >> keyword;
+        if (keyword != "mtllib") {
+            continue;
+        }
+        while (words >> library) {
+            hash = fnv1a(library.data(), library.size(), hash);
+            FileData material;
+            if (fileSystem.read((directory / library).string(), material)) {
+                hash = fnv1a(material.data(), material.size(), hash);
+            }
+        }
+    }
+    return true;
+}
+
+bool saveBakedModel(const std::string &path, const ModelData &model,
+                    uint64_t sourceHash, MeshVertexFormat format) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Erreur : Impossible d'écrire le modèle précalculé : "
+                  << path << std::endl;
+        return false;
+    }
+
+    ConvertedArrays converted;
+    const MeshArrays arrays = modelArrays(model, format, converted);
+    auto align = [](uint64_t offset) {
+        return alignOffset(offset, MESH_FILE_ALIGNMENT);
+    };
+    const size_t vertexBytes = arrays.vertexCount * vertexSize(format);
+    const size_t indexBytes = arrays.indexCount * arrays.indexSize;
+    const size_t submeshBytes = arrays.submeshCount * sizeof(SubMesh);
+    const size_t materialBytes = arrays.materialCount * 3 * sizeof(float);
+
+    MeshFileHeader header = {};
+    std::copy(MESH_FILE_MAGIC, MESH_FILE_MAGIC + 4, header.magic);
+    header.version = MESH_FILE_VERSION;
+    header.sourceHash = sourceHash;
+    header.vertexCount = static_cast<uint32_t>(arrays.vertexCount);
+    header.indexCount = static_cast<uint32_t>(arrays.indexCount);
+    header.submeshCount = static_cast<uint32_t>(arrays.submeshCount);
+    header.vertexFormat = static_cast<uint32_t>(format);
+    header.indexSize = static_cast<uint32_t>(arrays.indexSize);
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = arrays.boundsMin[axis];
+        header.boundsMax[axis] = arrays.boundsMax[axis];
+    }
+    header.materialCount = static_cast<uint32_t>(arrays.materialCount);
+    header.vertexOffset = align(sizeof(MeshFileHeader));
+    header.indexOffset = align(header.vertexOffset + vertexBytes);
+    header.submeshOffset = align(header.indexOffset + indexBytes);
+    header.materialOffset = align(header.submeshOffset + submeshBytes);
+    header.lodCount = static_cast<uint32_t>(arrays.lodCount);
+    header.lodOffset = align(header.materialOffset + materialBytes);
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeAt(file, header.vertexOffset, arrays.vertices, vertexBytes);
+    writeAt(file, header.indexOffset, arrays.indices, indexBytes);
+    writeAt(file, header.submeshOffset, arrays.submeshes, submeshBytes);
+    writeAt(file, header.materialOffset, arrays.materialColors, materialBytes);
+    writeAt(file, header.lodOffset, arrays.lods,
+            arrays.lodCount * sizeof(MeshLod));
+
+    if (!file) {
+        std::cerr << "Erreur : Écriture incomplète du modèle précalculé : "
+                  << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<PreparedMesh> prepareBakedMesh(const std::string &path,
+                                               uint64_t sourceHash,
+                                               MeshVertexFormat format) {
+    auto prepared = std::make_shared<PreparedMesh>();
+    FileData &file = prepared->file;
+    if (!VirtualFileSystem::get().read(path, file) ||
+        file.size() < sizeof(MeshFileHeader)) {
+        return nullptr; // Pas encore précalculé
+    }
+
+    const MeshFileHeader *header =
+        reinterpret_cast<const MeshFileHeader *>(file.data());
+    if (!std::equal(header->magic, header->magic + 4, MESH_FILE_MAGIC) ||
+        header->version != MESH_FILE_VERSION ||
+        header->sourceHash != sourceHash) {
+        return nullptr; // Format ancien ou source modifiée
+    }
+    // Un modèle à trop de matériaux est précalculé en FLOAT même si PACKED
+    // est demandé (voir modelVertexFormat)
+    const MeshVertexFormat fileFormat =
+        static_cast<MeshVertexFormat>(header->vertexFormat);
+    if (fileFormat != format && (format != MeshVertexFormat::PACKED ||
+                                 fileFormat != MeshVertexFormat::FLOAT)) {
+        return nullptr; // Autre format de sommets
+    }
+    if (header->indexSize != sizeof(uint16_t) &&
+        header->indexSize != sizeof(uint32_t)) {
+        std::cerr << "Erreur : Taille d'indice invalide : " << path
+                  << std::endl;
+        return nullptr;
+    }
+
+    // Chaque tableau doit être aligné et tenir dans le fichier
+    const size_t vertexBytes =
+        static_cast<size_t>(header->vertexCount) * vertexSize(fileFormat);
+    const size_t indexBytes =
+        static_cast<size_t>(header->indexCount) * header->indexSize;
+    const size_t submeshBytes =
+        static_cast<size_t>(header->submeshCount) * sizeof(SubMesh);
+    const size_t materialBytes =
+        static_cast<size_t>(header->materialCount) * 3 * sizeof(float);
+    const size_t lodBytes =
+        static_cast<size_t>(header->lodCount) * sizeof(MeshLod);
+    auto validArray = [&](uint64_t offset, size_t bytes) {
+        return offset % MESH_FILE_ALIGNMENT == 0 && offset <= file.size() &&
+               bytes <= file.size() - offset;
+    };
+    if (!validArray(header->vertexOffset, vertexBytes) ||
+        !validArray(header->indexOffset, indexBytes) ||
+        !validArray(header->submeshOffset, submeshBytes) ||
+        !validArray(header->materialOffset, materialBytes) ||
+        !validArray(header->lodOffset, lodBytes) || header->lodCount == 0) {
+        std::cerr << "Erreur : Modèle précalculé tronqué ou corrompu : "
+                  << path << std::endl;
+        return nullptr;
+    }
+
+    const SubMesh *submeshes =
+        reinterpret_cast<const SubMesh *>(file.data() + header->submeshOffset);
+    for (uint32_t i = 0; i < header->submeshCount; i++) {
+        if (submeshes[i].firstIndex > header->indexCount ||
+            submeshes[i].indexCount >
+                header->indexCount - submeshes[i].firstIndex) {
+            std::cerr << "Erreur : Sous-mesh hors des indices : " << path
+                      << std::endl;
+            return nullptr;
+        }
+    }
+    const MeshLod *lods =
+        reinterpret_cast<const MeshLod *>(file.data() + header->lodOffset);
+    for (uint32_t i = 0; i < header->lodCount; i++) {
+        if (lods[i].firstSubmesh > header->submeshCount ||
+            lods[i].submeshCount >
+                header->submeshCount - lods[i].firstSubmesh) {
+            std::cerr << "Erreur : Niveau de détail hors des sous-meshes : "
+                      << path << std::endl;
+            return nullptr;
+        }
+    }
+
+    // Les pages projetées seront copiées directement dans les tampons du GPU
+    MeshArrays &arrays = prepared->arrays;
+    arrays.format = fileFormat;
+    arrays.vertices = file.data() + header->vertexOffset;
+    arrays.vertexCount = header->vertexCount;
+    arrays.indices = file.data() + header->indexOffset;
+    arrays.indexCount = header->indexCount;
+    arrays.indexSize = header->indexSize;
+    arrays.submeshes = submeshes;
+    arrays.submeshCount = header->submeshCount;
+    arrays.materialColors =
+        reinterpret_cast<const float *>(file.data() + header->materialOffset);
+    arrays.materialCount = header->materialCount;
+    arrays.lods = lods;
+    arrays.lodCount = header->lodCount;
+    arrays.boundsMin = glm::vec3(header->boundsMin[0], header->boundsMin[1],
+                                 header->boundsMin[2]);
+    arrays.boundsMax = glm::vec3(header->boundsMax[0], header->boundsMax[1],
+                                 header->boundsMax[2]);
+    return prepared;
+}
@@ -0,0 +1,72 @@
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mesh.hpp"
+
+// Nombre de floats par sommet : position, couleur, normale
+#define MODEL_VERTEX_FLOATS 9
+
+// Modèle importé, encore sur le CPU
+struct ModelData {
+    std::vector<float> vertices; // MODEL_VERTEX_FLOATS floats par sommet
+    std::vector<unsigned int> indices; // Relatifs au baseVertex du sous-mesh
+    // Un par mesh Assimp et par niveau de détail (voir lods)
+    std::vector<SubMesh> submeshes;
+    glm::vec3 boundsMin, boundsMax; // Boîte englobante du modèle entier
+    // Couleur diffuse de chaque matériau (au plus MESH_MAX_MATERIALS)
+    std::vector<glm::vec3> materialColors;
+    // Niveaux de détail (voir buildModelLods). Vide : un seul niveau, fait
+    // de tous les sous-meshes.
+    std::vector<MeshLod> lods;
+};
+
+// Importer un modèle (OBJ...) avec Assimp. Chaque mesh Assimp devient un
+// sous-mesh ; la couleur de chaque sommet est la couleur diffuse de son
+// matériau.
+bool loadModelData(const std::string &path, ModelData &model);
+
+// Format des sommets d'un modèle importé : format, sauf si PACKED est
+// demandé et que le modèle a plus de MESH_MAX_MATERIALS matériaux, la
+// palette du shader ne pouvant les représenter. Un avertissement est alors
+// affiché et les sommets restent en FLOAT, avec leur propre couleur.
+MeshVertexFormat modelVertexFormat(const std::string &path,
+                                   const ModelData &model,
+                                   MeshVertexFormat format);
+
+// Hachage (FNV-1a) du fichier source d'un modèle et des fichiers de
+// matériaux qu'il cite (lignes mtllib des OBJ)
+bool hashModelSources(const std::string &path, uint64_t &hash);
+
+// Écrire un modèle importé au format précalculé (voir mesh_file.hpp), avec
+// des sommets au format demandé
+bool saveBakedModel(const std::string &path, const ModelData &model,
+                    uint64_t sourceHash, MeshVertexFormat format);
+
+// Modèle décodé sur le CPU, prêt à être envoyé au GPU. La préparation
+// n'appelle pas OpenGL : elle peut se faire sur un thread de travail (voir
+// AssetLoader), l'envoi restant sur le thread GL.
+struct PreparedMesh;
+
+// Préparer l'envoi d'un modèle importé, avec des sommets au format demandé
+std::shared_ptr<PreparedMesh> prepareMesh(ModelData model,
+                                          MeshVertexFormat format);
+
+// Projeter et valider un modèle précalculé, sans Assimp ni OpenGL. Renvoie
+// nullptr si le fichier manque, est invalide, ne correspond plus à
+// sourceHash ou n'est pas au format demandé (un modèle précalculé en FLOAT
+// est accepté pour PACKED, voir modelVertexFormat).
+std::shared_ptr<PreparedMesh> prepareBakedMesh(const std::string &path,
+                                               uint64_t sourceHash,
+                                               MeshVertexFormat format);
+
+// Créer les tampons d'un modèle préparé dans mesh, encore vide. À appeler
+// sur le thread GL.
+void uploadPreparedMesh(const PreparedMesh &prepared, Mesh &mesh);
+
+#endif
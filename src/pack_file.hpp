@@ -0,0 +1,55 @@
+#ifndef PACK_FILE_H
+#define PACK_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Format binaire des archives d'assets (.pack), écrites par l'outil
+// tools/pack_assets.cpp (make pack) et projetées en mémoire par
+// VirtualFileSystem : un seul fichier ouvert pour tous les modèles,
+// textures et shaders.
+//
+//   PackFileHeader
+//   entrées : entryCount x PackEntry, triées par chemin
+//   chemins : chemins relatifs des fichiers, à la suite, sans zéro final
+//   données : contenu de chaque fichier, brut ou compressé en LZ4
+//
+// Chaque contenu commence sur une frontière de PACK_FILE_ALIGNMENT octets :
+// un fichier précalculé non compressé (.mesh, .btex) garde l'alignement de
+// ses tableaux et se lit directement dans les pages de l'archive.
+
+#define PACK_FILE_MAGIC "OGLP"
+#define PACK_FILE_VERSION 1
+#define PACK_FILE_ALIGNMENT 64
+// Archive cherchée au lancement, à côté de l'exécutable
+#define PACK_FILE_DEFAULT_PATH "assets.pack"
+
+// Compression du contenu d'une entrée
+enum class PackCompression : uint32_t {
+    NONE = 0,
+    LZ4 = 1 // Bloc LZ4 (voir lz4_block.hpp)
+};
+
+struct PackFileHeader {
+    char magic[4]; // PACK_FILE_MAGIC
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t padding;
+    uint64_t entryOffset; // Position de la table des entrées
+    uint64_t nameOffset;  // Position des chemins
+};
+
+struct PackEntry {
+    uint64_t offset;     // Position du contenu dans l'archive
+    uint64_t storedSize; // Taille du contenu dans l'archive
+    uint64_t size;       // Taille du fichier une fois décompressé
+    uint32_t nameOffset; // Position du chemin, relative à nameOffset
+    uint32_t nameLength;
+    uint32_t compression; // PackCompression
+    uint32_t padding;
+};
+
+static_assert(sizeof(PackFileHeader) == 32, "En-tête d'archive mal aligné");
+static_assert(sizeof(PackEntry) == 40, "Entrée d'archive mal alignée");
+
+#endif
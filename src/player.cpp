@@ -1,7 +1,8 @@
 #include "player.hpp"
 Player::Player(const glm::vec3 &startPosition, const glm::vec3 &cameraOffset,
-               const PlayerCameraConfig &config)
-    : cameraOffset(cameraOffset), cameraConfig(config)
+               const PlayerCameraConfig &config,
+               std::shared_ptr<const Mesh> carMesh)
+    : cameraOffset(cameraOffset), cameraConfig(config), car(std::move(carMesh))
       {
         
     lookingBehind = false;
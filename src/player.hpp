@@ -3,6 +3,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <memory>
 
 #include "config.hpp"
 #include "car.hpp"
@@ -25,18 +26,13 @@ class Player{
 
     public:
     Car car;
-    Player(const glm::vec3& startPosition, const glm::vec3& cameraOffset, const PlayerCameraConfig& config);
+    Player(const glm::vec3& startPosition, const glm::vec3& cameraOffset, const PlayerCameraConfig& config, std::shared_ptr<const Mesh> carMesh);
     void updateCamera(); // Mettre à jour la caméra
     glm::mat4 getViewMatrix() const { return viewMatrix; }
     glm::mat4 getProjectionMatrix() const { return projectionMatrix; }
+    const PlayerCameraConfig &getCameraConfig() const { return cameraConfig; }
     void move(glm::vec3 delta);
     void rotate(float angle);
-    void render(const unsigned int shaderProgram){
-        car.render(shaderProgram, viewMatrix, projectionMatrix);
-    }
-    void renderForShadowMap(unsigned int shaderProgram, GLuint shadowModelLoc){
-        car.renderForShadowMap(shaderProgram, shadowModelLoc);
-    }
     glm::vec3 getViewPos(){
         if(lookingBehind){
             return car.position + cameraOffset + car.direction * 5.0f;
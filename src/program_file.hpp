@@ -0,0 +1,39 @@
+#ifndef PROGRAM_FILE_H
+#define PROGRAM_FILE_H
+
+#include <cstdint>
+
+// Format binaire du cache des programmes GLSL (.bprog) : le binaire rendu
+// par glGetProgramBinary après une édition de liens, rechargé par
+// glProgramBinary aux lancements suivants pour éviter de recompiler.
+//
+//   ProgramFileHeader
+//   binaire : binarySize octets, à PROGRAM_FILE_ALIGNMENT octets du début
+//
+// Un fichier par couple de sources, dans PROGRAM_CACHE_DIRECTORY. sourceHash
+// est le hachage FNV-1a des deux sources, du fabricant, du renderer et de
+// la version du pilote : s'il ne correspond plus (source modifiée, autre
+// GPU, pilote mis à jour), ou si le pilote refuse le binaire, le programme
+// est recompilé et le fichier réécrit.
+
+#define PROGRAM_FILE_MAGIC "OGLS"
+#define PROGRAM_FILE_VERSION 1
+#define PROGRAM_FILE_ALIGNMENT 32
+#define PROGRAM_FILE_EXTENSION ".bprog"
+#define PROGRAM_CACHE_DIRECTORY "shader_cache"
+// Taille maximale d'un binaire accepté
+#define PROGRAM_MAX_BINARY_SIZE (64u << 20)
+
+struct ProgramFileHeader {
+    char magic[4]; // PROGRAM_FILE_MAGIC
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t binaryFormat; // Format propre au pilote, pour glProgramBinary
+    uint32_t padding;
+    uint64_t binarySize;
+};
+
+static_assert(sizeof(ProgramFileHeader) == PROGRAM_FILE_ALIGNMENT,
+              "En-tête de programme mal aligné");
+
+#endif
@@ -0,0 +1,391 @@
+#include "shader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "gl_extensions.hpp"
+#include "hash.hpp"
+#include "program_file.hpp"
+#include "virtual_file_system.hpp"
+
+std::string loadShaderSource(const std::string &path) {
+    // Lire le fichier, dans l'archive des assets ou sur le disque
+    FileData shaderFile;
+    if (!VirtualFileSystem::get().read(path, shaderFile)) {
+        std::cerr << "Erreur : Impossible d'ouvrir le fichier shader : "
+                  << path << std::endl;
+        return "";
+    }
+    return std::string(reinterpret_cast<const char *>(shaderFile.data()),
+                       shaderFile.size());
+}
+
+// Compiler un shader. 0 en cas d'échec.
+static unsigned int compileShader(const std::string &source,
+                                  const std::string &path,
+                                  GLenum shaderType) {
+    if (source.empty()) {
+        std::cerr << "Erreur : Shader vide : " << path << std::endl;
+        return 0;
+    }
+
+    const char *shaderCode = source.c_str();
+    unsigned int shader = glCreateShader(shaderType);
+    glShaderSource(shader, 1, &shaderCode, NULL);
+    glCompileShader(shader);
+
+    // Vérification des erreurs
+    int success;
+    char infoLog[512];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cerr << "Erreur de compilation du shader " << path << " :\n"
+                  << infoLog << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Clé du cache : hachage des deux sources et du pilote courant
+static uint64_t programHash(const std::string &vertexSource,
+                            const std::string &fragmentSource) {
+    uint64_t hash = FNV1A_OFFSET_BASIS;
+    for (const std::string *source : {&vertexSource, &fragmentSource}) {
+        const uint64_t size = source->size();
+        hash = fnv1a(&size, sizeof(size), hash);
+        hash = fnv1a(source->data(), source->size(), hash);
+    }
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char *value = reinterpret_cast<const char *>(glGetString(name));
+        if (value) {
+            hash = fnv1a(value, std::strlen(value) + 1, hash);
+        }
+    }
+    return hash;
+}
+
+// Fichier du cache d'un couple de sources
+static std::string programCachePath(const std::string &vertexPath,
+                                    const std::string &fragmentPath) {
+    const std::string paths = VirtualFileSystem::normalizePath(vertexPath) +
+                              '\n' +
+                              VirtualFileSystem::normalizePath(fragmentPath);
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx",
+                  static_cast<unsigned long long>(
+                      fnv1a(paths.data(), paths.size())));
+    return std::string(PROGRAM_CACHE_DIRECTORY) + "/" + name +
+           PROGRAM_FILE_EXTENSION;
+}
+
+// Recréer un programme depuis son binaire en cache. 0 si le cache manque,
+// ne correspond plus à sourceHash ou si le pilote refuse le binaire.
+static unsigned int loadCachedProgram(const std::string &path,
+                                      uint64_t sourceHash) {
+    FileData file;
+    if (!glProgramBinaryExt || !VirtualFileSystem::get().read(path, file) ||
+        file.size() < sizeof(ProgramFileHeader)) {
+        return 0; // Pas encore en cache
+    }
+    const ProgramFileHeader *header =
+        reinterpret_cast<const ProgramFileHeader *>(file.data());
+    if (!std::equal(header->magic, header->magic + 4, PROGRAM_FILE_MAGIC) ||
+        header->version != PROGRAM_FILE_VERSION ||
+        header->sourceHash != sourceHash) {
+        return 0; // Format ancien, source modifiée ou autre pilote
+    }
+    if (header->binarySize == 0 ||
+        header->binarySize > PROGRAM_MAX_BINARY_SIZE ||
+        header->binarySize > file.size() - sizeof(ProgramFileHeader)) {
+        std::cerr << "Erreur : Programme en cache tronqué ou corrompu : "
+                  << path << std::endl;
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    glProgramBinaryExt(program, header->binaryFormat,
+                       file.data() + sizeof(ProgramFileHeader),
+                       static_cast<GLsizei>(header->binarySize));
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // Binaire d'un état du pilote que la clé ne distingue pas : il
+        // sera recompilé et remplacé
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Écrire le binaire d'un programme lié dans le cache
+static bool saveCachedProgram(unsigned int program, const std::string &path,
+                              uint64_t sourceHash) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false; // Le pilote n'a rien à fournir pour ce programme
+    }
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinaryExt(program, length, &written, &binaryFormat,
+                          binary.data());
+    if (written <= 0) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIRECTORY, error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Erreur : Impossible d'écrire le programme en cache : "
+                  << path << std::endl;
+        return false;
+    }
+    ProgramFileHeader header = {};
+    std::copy(PROGRAM_FILE_MAGIC, PROGRAM_FILE_MAGIC + 4, header.magic);
+    header.version = PROGRAM_FILE_VERSION;
+    header.sourceHash = sourceHash;
+    header.binaryFormat = binaryFormat;
+    header.binarySize = static_cast<uint64_t>(written);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    return static_cast<bool>(file);
+}
+
+// Lier un programme à partir de ses sources, depuis le cache des binaires
+// si possible, en compilant sinon. 0 en cas d'échec.
+static unsigned int linkProgram(const std::string &vertexSource,
+                                const std::string &vertexPath,
+                                const std::string &fragmentSource,
+                                const std::string &fragmentPath) {
+    const bool cached = glProgramBinaryExt != nullptr &&
+                        !vertexSource.empty() && !fragmentSource.empty();
+    uint64_t sourceHash = 0;
+    std::string cachePath;
+    if (cached) {
+        sourceHash = programHash(vertexSource, fragmentSource);
+        cachePath = programCachePath(vertexPath, fragmentPath);
+        unsigned int program = loadCachedProgram(cachePath, sourceHash);
+        if (program) {
+            return program;
+        }
+    }
+
+    unsigned int vertexShader =
+        compileShader(vertexSource, vertexPath, GL_VERTEX_SHADER);
+    unsigned int fragmentShader =
+        compileShader(fragmentSource, fragmentPath, GL_FRAGMENT_SHADER);
+    if (vertexShader == 0 || fragmentShader == 0) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    unsigned int shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    if (cached) {
+        // Garder le binaire lié pour le mettre en cache
+        glProgramParameteriExt(shaderProgram,
+                               GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(shaderProgram);
+
+    // Nettoyage : le programme garde le code lié
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    // Vérification des erreurs de linkage
+    int success;
+    char infoLog[512];
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        std::cerr << "Erreur de linkage du shader program (" << vertexPath
+                  << ", " << fragmentPath << ") :\n"
+                  << infoLog << std::endl;
+        glDeleteProgram(shaderProgram);
+        return 0;
+    }
+    if (cached) {
+        saveCachedProgram(shaderProgram, cachePath, sourceHash);
+    }
+    return shaderProgram;
+}
+
+unsigned int createShaderProgram(const std::string &vertexPath,
+                                 const std::string &fragmentPath) {
+    return linkProgram(loadShaderSource(vertexPath), vertexPath,
+                       loadShaderSource(fragmentPath), fragmentPath);
+}
+
+ShaderProgram::ShaderProgram(const std::string &vertexPath,
+                             const std::string &fragmentPath)
+    : vertexPath(VirtualFileSystem::normalizePath(vertexPath)),
+      fragmentPath(VirtualFileSystem::normalizePath(fragmentPath)),
+      program(createShaderProgram(vertexPath, fragmentPath)) {
+    reflectUniforms();
+}
+
+bool ShaderProgram::usesFile(const std::string &path) const {
+    return path == vertexPath || path == fragmentPath;
+}
+
+void ShaderProgram::setLinkCallback(
+    std::function<void(ShaderProgram &)> callback) {
+    linkCallback = std::move(callback);
+    if (program && linkCallback) {
+        linkCallback(*this);
+    }
+}
+
+void ShaderProgram::reflectUniforms() {
+    activeUniforms.clear();
+    int count = 0, maxLength = 0;
+    if (program) {
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    }
+    std::vector<char> name(static_cast<size_t>(std::max(maxLength, 1)));
+    for (int i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, static_cast<GLuint>(i),
+                           static_cast<GLsizei>(name.size()), &length, &size,
+                           &type, name.data());
+        std::string uniformName(name.data(), static_cast<size_t>(length));
+        // Un tableau est listé par son premier élément
+        const std::string arraySuffix = "[0]";
+        if (uniformName.size() > arraySuffix.size() &&
+            uniformName.compare(uniformName.size() - arraySuffix.size(),
+                                arraySuffix.size(), arraySuffix) == 0) {
+            uniformName.resize(uniformName.size() - arraySuffix.size());
+        }
+        // Les uniformes des blocs n'ont pas d'emplacement (-1)
+        const int location = glGetUniformLocation(program, name.data());
+        if (location >= 0) {
+            activeUniforms[uniformName] = location;
+        }
+    }
+
+    // Nouveau programme : emplacements relus, valeurs à renvoyer
+    for (Uniform &uniform : uniforms) {
+        auto active = activeUniforms.find(uniform.name);
+        uniform.location = active != activeUniforms.end() ? active->second : -1;
+        uniform.sent = false;
+    }
+}
+
+UniformHandle ShaderProgram::uniform(const std::string &name) {
+    auto known = uniformIndices.find(name);
+    if (known != uniformIndices.end()) {
+        return {known->second};
+    }
+    Uniform uniform;
+    uniform.name = name;
+    auto active = activeUniforms.find(name);
+    uniform.location = active != activeUniforms.end() ? active->second : -1;
+    uniform.sent = false;
+    const int index = static_cast<int>(uniforms.size());
+    uniforms.push_back(uniform);
+    uniformIndices[name] = index;
+    return {index};
+}
+
+ShaderProgram::Uniform *
+ShaderProgram::changedUniform(UniformHandle handle, const void *value,
+                              size_t size) {
+    if (handle.index < 0 ||
+        handle.index >= static_cast<int>(uniforms.size())) {
+        return nullptr;
+    }
+    Uniform &uniform = uniforms[handle.index];
+    if (uniform.location < 0 ||
+        (uniform.sent && uniform.value.size() == size &&
+         std::memcmp(uniform.value.data(), value, size) == 0)) {
+        return nullptr;
+    }
+    const unsigned char *bytes = static_cast<const unsigned char *>(value);
+    uniform.value.assign(bytes, bytes + size);
+    uniform.sent = true;
+    return &uniform;
+}
+
+void ShaderProgram::set(UniformHandle handle, int value) {
+    if (Uniform *uniform = changedUniform(handle, &value, sizeof(value))) {
+        glUniform1i(uniform->location, value);
+    }
+}
+
+void ShaderProgram::set(UniformHandle handle, float value) {
+    if (Uniform *uniform = changedUniform(handle, &value, sizeof(value))) {
+        glUniform1f(uniform->location, value);
+    }
+}
+
+void ShaderProgram::set(UniformHandle handle, const glm::vec3 &value) {
+    if (Uniform *uniform = changedUniform(handle, &value, sizeof(value))) {
+        glUniform3fv(uniform->location, 1, &value.x);
+    }
+}
+
+void ShaderProgram::set(UniformHandle handle, const glm::mat4 &value) {
+    if (Uniform *uniform = changedUniform(handle, &value, sizeof(value))) {
+        glUniformMatrix4fv(uniform->location, 1, GL_FALSE, &value[0][0]);
+    }
+}
+
+void ShaderProgram::set(UniformHandle handle, const glm::vec3 *values,
+                        int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (Uniform *uniform =
+            changedUniform(handle, values, count * sizeof(glm::vec3))) {
+        glUniform3fv(uniform->location, count, &values[0].x);
+    }
+}
+
+void ShaderProgram::reload(AssetLoader &loader) {
+    struct Sources {
+        std::string vertex, fragment;
+    };
+    const std::string vertexPath = this->vertexPath;
+    const std::string fragmentPath = this->fragmentPath;
+    loader.load([this, vertexPath, fragmentPath]() -> AssetLoader::UploadStep {
+        // Lecture en arrière-plan ; compilation sur le thread GL
+        auto sources = std::make_shared<Sources>();
+        sources->vertex = loadShaderSource(vertexPath);
+        sources->fragment = loadShaderSource(fragmentPath);
+        return [this, sources] {
+            unsigned int linked =
+                linkProgram(sources->vertex, this->vertexPath,
+                            sources->fragment, this->fragmentPath);
+            if (linked == 0) {
+                std::cerr << "Erreur : Programme conservé : "
+                          << this->vertexPath << ", " << this->fragmentPath
+                          << std::endl;
+                return;
+            }
+            glDeleteProgram(program);
+            program = linked;
+            reflectUniforms();
+            std::cout << "Programme rechargé : " << this->vertexPath << ", "
+                      << this->fragmentPath << std::endl;
+            if (linkCallback) {
+                linkCallback(*this);
+            }
+        };
+    });
+}
@@ -0,0 +1,125 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include "../include/glad/glad.h"
+#include <functional>
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asset_loader.hpp"
+
+// Lire le source d'un shader, dans l'archive des assets ou sur le disque.
+// Vide en cas d'échec.
+std::string loadShaderSource(const std::string &path);
+
+// Compiler et lier un programme à partir de ses deux fichiers sources. Si
+// le pilote sait rendre les programmes liés, leur binaire est gardé dans le
+// cache (voir program_file.hpp) et rechargé aux lancements suivants sans
+// recompiler. Renvoie 0 (erreurs affichées) si la compilation ou l'édition de liens
+// échoue.
+unsigned int createShaderProgram(const std::string &vertexPath,
+                                 const std::string &fragmentPath);
+
+// Uniforme d'un ShaderProgram, obtenu une fois par ShaderProgram::uniform
+// et valable pour toute la vie du programme, rechargements compris
+struct UniformHandle {
+    int index = -1;
+};
+
+// Programme GLSL rechargeable. Un rechargement relit les sources en
+// arrière-plan puis compile sur le thread GL : le programme n'est remplacé
+// que si l'édition de liens réussit, l'ancien restant actif sinon.
+//
+// Les uniformes actifs sont listés (glGetActiveUniform) après chaque
+// édition de liens. Les setters prennent un UniformHandle et ne consultent
+// jamais le pilote par nom ; ils n'envoient la valeur que si elle a changé
+// depuis le dernier envoi au même programme. Un uniforme absent du
+// programme (inutilisé, donc éliminé par le compilateur) est ignoré. Les
+// uniformes fixes sont renvoyés au nouveau programme par la fonction donnée
+// à setLinkCallback.
+class ShaderProgram {
+  public:
+    // Compiler et lier le programme immédiatement
+    ShaderProgram(const std::string &vertexPath,
+                  const std::string &fragmentPath);
+    ~ShaderProgram() { glDeleteProgram(program); }
+
+    ShaderProgram(const ShaderProgram &) = delete;
+    ShaderProgram &operator=(const ShaderProgram &) = delete;
+
+    // Programme actuel (0 si la première compilation a échoué)
+    unsigned int getId() const { return program; }
+
+    // path (normalisé, voir VirtualFileSystem) est-il l'un des sources
+    bool usesFile(const std::string &path) const;
+
+    // Fonction appelée après chaque remplacement du programme, et tout de
+    // suite s'il est valide
+    void setLinkCallback(std::function<void(ShaderProgram &)> callback);
+
+    // Uniforme name (sans [0] pour un tableau). Recherche par nom : à faire
+    // une fois, hors de la boucle de rendu (voir UniformCache).
+    UniformHandle uniform(const std::string &name);
+
+    // Envoyer la valeur d'un uniforme au programme, qui doit être actif
+    void set(UniformHandle handle, int value);
+    void set(UniformHandle handle, float value);
+    void set(UniformHandle handle, const glm::vec3 &value);
+    void set(UniformHandle handle, const glm::mat4 &value);
+    // Tableau de count vec3
+    void set(UniformHandle handle, const glm::vec3 *values, int count);
+
+    // Recompiler le programme depuis ses sources (voir plus haut). Le
+    // programme doit vivre jusqu'à la fin des envois de loader.
+    void reload(AssetLoader &loader);
+
+  private:
+    // Uniforme demandé par uniform() : emplacement dans le programme
+    // actuel (-1 s'il en est absent) et dernière valeur envoyée
+    struct Uniform {
+        std::string name;
+        int location;
+        bool sent;                        // value est valide
+        std::vector<unsigned char> value; // Octets envoyés (tableaux compris)
+    };
+
+    std::string vertexPath, fragmentPath;
+    unsigned int program;
+    std::function<void(ShaderProgram &)> linkCallback;
+    std::unordered_map<std::string, int> activeUniforms; // Nom -> location
+    std::vector<Uniform> uniforms;                       // Par handle
+    std::unordered_map<std::string, int> uniformIndices; // Nom -> handle
+
+    // Lister les uniformes actifs du programme et relier les handles
+    void reflectUniforms();
+
+    // Uniforme de handle à envoyer : nullptr s'il est absent du programme ou
+    // si les size octets de value sont déjà ceux du programme
+    Uniform *changedUniform(UniformHandle handle, const void *value,
+                            size_t size);
+};
+
+// Handles d'un groupe d'uniformes (Uniforms, construit à partir d'un
+// ShaderProgram &), obtenus une fois par programme puis réutilisés à chaque
+// rendu. Les programmes doivent vivre aussi longtemps que le cache.
+template <typename Uniforms> class UniformCache {
+  public:
+    // Handles de program (la référence reste valable jusqu'au get suivant)
+    const Uniforms &get(ShaderProgram &program) {
+        for (const auto &entry : entries) {
+            if (entry.first == &program) {
+                return entry.second;
+            }
+        }
+        entries.emplace_back(&program, Uniforms(program));
+        return entries.back().second;
+    }
+
+  private:
+    std::vector<std::pair<const ShaderProgram *, Uniforms>> entries;
+};
+
+#endif
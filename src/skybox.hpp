@@ -1,26 +1,79 @@
 #ifndef SKYBOX_H
 #define SKYBOX_H
 
-#define STB_IMAGE_IMPLEMENTATION
 #include "../include/glad/glad.h"
-#include "../include/stb/stb_image.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "asset_loader.hpp"
+#include "gl_extensions.hpp"
+#include "shader.hpp"
+#include "texture_loader.hpp"
+#include "thread_pool.hpp"
+#include "virtual_file_system.hpp"
+
 class Skybox {
   public:
-    // Constructeur
-    Skybox(const std::vector<std::string> &faces) { loadCubemap(faces); }
+    // Constructeur : les faces sont décodées et envoyées immédiatement
+    Skybox(const std::vector<std::string> &faces) : faces(faces) {
+        createCubemap();
+        std::shared_ptr<CubemapFaces> decoded = decodeFaces(faces, nullptr);
+        if (decoded) {
+            uploadFaces(cubemapTexture, *decoded);
+        }
+        createCube();
+    }
+
+    // Faces décodées en arrière-plan, en parallèle, par loader ; la cubemap
+    // reste d'une couleur unie jusqu'à leur envoi. La skybox doit vivre
+    // jusqu'à la fin des envois de loader.
+    Skybox(const std::vector<std::string> &faces, AssetLoader &loader)
+        : faces(faces) {
+        createCubemap();
+        reload(loader);
+        createCube();
+    }
+
+    // Relire les faces en arrière-plan. Une nouvelle cubemap remplace
+    // l'actuelle à l'envoi (le stockage immuable ne peut être redéfini) ;
+    // l'actuelle reste affichée jusque-là, ou si le chargement échoue.
+    void reload(AssetLoader &loader) {
+        ThreadPool *pool = &loader.getThreadPool();
+        const std::vector<std::string> paths = faces;
+        loader.load([this, paths, pool]() -> AssetLoader::UploadStep {
+            std::shared_ptr<CubemapFaces> decoded = decodeFaces(paths, pool);
+            if (!decoded) {
+                return nullptr;
+            }
+            return [this, decoded] {
+                const unsigned int previous = cubemapTexture;
+                createCubemap();
+                uploadFaces(cubemapTexture, *decoded);
+                glDeleteTextures(1, &previous);
+            };
+        });
+    }
+
+    // path (normalisé, voir VirtualFileSystem) est-il l'une des faces
+    bool usesFile(const std::string &path) const {
+        for (const std::string &face : faces) {
+            if (VirtualFileSystem::normalizePath(face) == path) {
+                return true;
+            }
+        }
+        return false;
+    }
 
     // Fonction pour dessiner la skybox
-    void render(unsigned int shaderProgram, const glm::mat4 &view,
+    void render(ShaderProgram &program, const glm::mat4 &view,
                 const glm::mat4 &projection) {
-        glUseProgram(shaderProgram);
+        glUseProgram(program.getId());
         
         if (cubemapTexture == 0) {
             std::cout << "Erreur : La texture cubemap n'est pas valide !" << std::endl;
@@ -28,10 +81,9 @@ class Skybox {
         }
 
         // Passer les matrices de vue et de projection
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1,
-                           GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1,
-                           GL_FALSE, glm::value_ptr(projection));
+        const SkyboxUniforms &uniforms = skyboxUniforms.get(program);
+        program.set(uniforms.view, view);
+        program.set(uniforms.projection, projection);
         // Désactiver l'écriture dans le depth buffer (nous ne voulons pas que
         // la skybox écrase d'autres objets)
         glDepthFunc(GL_LEQUAL);
@@ -39,7 +91,7 @@ class Skybox {
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glUniform1i(glGetUniformLocation(shaderProgram, "skybox"), 0);
+        program.set(uniforms.skybox, 0);
 
 
         // Lier le VAO de la skybox et dessiner
@@ -64,14 +116,33 @@ class Skybox {
     }
 
   private:
+    std::vector<std::string> faces; // Images des faces (+X, -X, +Y, -Y, +Z, -Z)
     unsigned int cubemapTexture;
     unsigned int skyboxVAO, skyboxVBO, skyboxEBO;
 
-    // Fonction pour charger une cubemap
-    void loadCubemap(const std::vector<std::string> &faces) {
+    // Uniformes d'un programme de rendu de la skybox
+    struct SkyboxUniforms {
+        UniformHandle view, projection, skybox;
+
+        explicit SkyboxUniforms(ShaderProgram &program)
+            : view(program.uniform("view")),
+              projection(program.uniform("projection")),
+              skybox(program.uniform("skybox")) {}
+    };
+    // Pour chaque programme passé à render()
+    UniformCache<SkyboxUniforms> skyboxUniforms;
+
+    // Faces de la cubemap préparées (+X, -X, +Y, -Y, +Z, -Z)
+    struct CubemapFaces {
+        std::shared_ptr<PreparedTexture> faces[6];
+    };
+
+    // Créer la cubemap, d'un texel gris-bleu par face en attendant les
+    // images
+    void createCubemap() {
         glGenTextures(1, &cubemapTexture);
         if (cubemapTexture == 0) {
-            std::cout << "Erreur lors de la création de la texture cubemap !"
+            std::cerr << "Erreur lors de la création de la texture cubemap !"
                       << std::endl;
             return;
         }
@@ -85,37 +156,71 @@ class Skybox {
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R,
                         GL_CLAMP_TO_EDGE);
 
-        int width, height, nrChannels;
-        for (unsigned int i = 0; i < faces.size(); i++) {
-            unsigned char *data =
-                stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-            if (data) {
-                GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format,
-                             width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-                stbi_image_free(data);
-            } else {
-                std::cout << "Échec du chargement de la texture cubemap à "
-                             "l'emplacement : "
-                          << faces[i] << std::endl;
-                stbi_image_free(data);
-            }
+        const unsigned char placeholder[4] = {128, 160, 200, 255};
+        for (unsigned int i = 0; i < 6; i++) {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, 1, 1,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
         }
-        
-        // Vérifier que la texture a bien été créée et configurée
-        GLint textureStatus;
-        glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP, 0, GL_TEXTURE_WIDTH,
-            &textureStatus);
-            if (cubemapTexture == 0) {
-            std::cout << "Erreur : La texture cubemap n'a pas été générée !" << std::endl;
+    }
+
+    // Préparer les 6 faces (sans OpenGL), chacune sur un thread de pool
+    // s'il est donné. Les faces sont compressées en BC1 (et précalculées,
+    // voir texture_loader.hpp) si le pilote le permet. nullptr si une face
+    // manque, si les faces ne sont pas des carrés de même taille ou si leurs
+    // formats diffèrent.
+    static std::shared_ptr<CubemapFaces>
+    decodeFaces(const std::vector<std::string> &faces, ThreadPool *pool) {
+        if (faces.size() != 6) {
+            std::cerr << "Erreur : Une cubemap a 6 faces, pas " << faces.size()
+                      << std::endl;
+            return nullptr;
         }
-        
-        for (unsigned int i = 0; i < faces.size(); i++) {
-            if (!stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0)) {
-                std::cout << "⚠ Erreur de chargement de la texture : " << faces[i] << std::endl;
+        auto decoded = std::make_shared<CubemapFaces>();
+        const bool compressed = glTextureCompressionS3TC;
+        auto decodeFace = [&](size_t i) {
+            decoded->faces[i] = prepareTexture(faces[i], compressed);
+        };
+        if (pool) {
+            pool->parallelFor(6, decodeFace);
+        } else {
+            for (size_t i = 0; i < 6; i++) {
+                decodeFace(i);
+            }
+        }
+
+        const std::shared_ptr<PreparedTexture> &first = decoded->faces[0];
+        for (unsigned int i = 0; i < 6; i++) {
+            const std::shared_ptr<PreparedTexture> &face = decoded->faces[i];
+            if (!face) {
+                std::cerr << "Erreur : Échec du chargement de la texture "
+                             "cubemap à l'emplacement : "
+                          << faces[i] << std::endl;
+                return nullptr;
             }
+            if (face->width != face->height || face->width != first->width ||
+                face->format != first->format) {
+                std::cerr << "Erreur : Les faces de la cubemap doivent être "
+                             "des carrés de même taille et de même format : "
+                          << faces[i] << " (" << face->width << "x"
+                          << face->height << ")" << std::endl;
+                return nullptr;
+            }
+        }
+        return decoded;
+    }
+
+    // Envoyer les faces préparées dans la cubemap texture, avec leurs
+    // mipmaps
+    static void uploadFaces(unsigned int texture, const CubemapFaces &faces) {
+        const PreparedTexture *images[6];
+        for (int i = 0; i < 6; i++) {
+            images[i] = faces.faces[i].get();
         }
-                                
+        uploadCubemap(texture, images);
+    }
+
+    // Créer le cube sur lequel la cubemap est dessinée
+    void createCube() {
         // Initialiser les données du cube (6 faces)
         float skyboxVertices[] = {
             // Positions X, Y, Z
@@ -0,0 +1,437 @@
+#include "terrain.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+Terrain::Terrain(const Map &map, ThreadPool &pool, TerrainVertexFormat format)
+    : format(format), mapWidth(map.getWidth()), mapDepth(map.getDepth()),
+      pixelErrorBudget(TERRAIN_PIXEL_ERROR) {
+    // x et z sont stockés tels quels sur 16 bits par le format PACKED
+    if (format == TerrainVertexFormat::PACKED &&
+        std::max(mapWidth, mapDepth) > UINT16_MAX) {
+        std::cerr << "Erreur : Carte trop grande pour des sommets compressés"
+                  << std::endl;
+        this->format = format = TerrainVertexFormat::FULL;
+    }
+    float minHeight = map.getGridHeight(0, 0);
+    float maxHeight = minHeight;
+    for (int x = 0; x <= mapWidth; x++) {
+        for (int z = 0; z <= mapDepth; z++) {
+            minHeight = std::min(minHeight, map.getGridHeight(x, z));
+            maxHeight = std::max(maxHeight, map.getGridHeight(x, z));
+        }
+    }
+    heightRange.offset = minHeight - TERRAIN_PACKED_HEIGHT_MARGIN;
+    heightRange.scale =
+        (maxHeight - minHeight + 2.0f * TERRAIN_PACKED_HEIGHT_MARGIN) /
+        UINT16_MAX;
+
+    chunksX = (mapWidth + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    chunksZ = (mapDepth + TERRAIN_CHUNK_SIZE - 1) / TERRAIN_CHUNK_SIZE;
+    const size_t chunkVertexCount = terrainGridVertexCount(TERRAIN_CHUNK_SIZE);
+    const size_t vertexSize = terrainVertexSize(format);
+    const auto buildStart = std::chrono::steady_clock::now();
+
+    // Tous les morceaux ont la même taille : les motifs d'indices de chaque
+    // niveau de détail et de chaque combinaison de bords raccordés sont
+    // partagés. Le niveau le plus grossier n'a jamais de voisin moins
+    // détaillé, ses motifs raccordés restent vides.
+    std::vector<TerrainIndex> indices;
+    for (int lod = 0; lod < TERRAIN_LOD_COUNT; lod++) {
+        for (unsigned int edges = 0; edges < 16; edges++) {
+            IndexPattern pattern;
+            pattern.firstIndex = static_cast<unsigned int>(indices.size());
+            if (lod + 1 < TERRAIN_LOD_COUNT || edges == 0) {
+                buildTerrainIndices(TERRAIN_CHUNK_SIZE, indices, 1 << lod,
+                                    edges);
+            }
+            pattern.indexCount =
+                static_cast<unsigned int>(indices.size()) - pattern.firstIndex;
+            patterns.push_back(pattern);
+        }
+    }
+
+    // Chaque morceau écrit dans sa propre tranche du tampon de sommets et sa
+    // propre entrée de chunks : les morceaux sont construits en parallèle
+    // sans synchronisation
+    chunks.resize(static_cast<size_t>(chunksX) * chunksZ);
+    std::vector<unsigned char> vertices(chunks.size() * chunkVertexCount *
+                                        vertexSize);
+    pool.parallelFor(chunks.size(), [&](size_t chunkIndex) {
+        TerrainChunk &chunk = chunks[chunkIndex];
+        chunk.baseVertex = static_cast<int>(chunkIndex * chunkVertexCount);
+        chunk.lod = 0;
+        chunk.stitchedEdges = 0;
+        buildChunk(map, chunkIndex, &vertices[chunk.baseVertex * vertexSize]);
+    });
+    const auto buildEnd = std::chrono::steady_clock::now();
+
+    // Création du VAO, VBO et EBO
+    glGenVertexArrays(1, &terrainVAO);
+    glGenBuffers(1, &terrainVBO);
+    glGenBuffers(1, &terrainEBO);
+
+    glBindVertexArray(terrainVAO);
+
+    // VBO : Envoi des sommets
+    glBindBuffer(GL_ARRAY_BUFFER, terrainVBO);
+    // Les morceaux modifiés sont renvoyés un à un (uploadDirtyChunks)
+    glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(),
+                 GL_DYNAMIC_DRAW);
+
+    // EBO : Envoi des indices
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, terrainEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 indices.size() * sizeof(TerrainIndex), indices.data(),
+                 GL_STATIC_DRAW);
+
+    setupTerrainVertexAttributes(format);
+
+    glBindVertexArray(0);
+
+    createTextures(map);
+
+    const auto uploadEnd = std::chrono::steady_clock::now();
+    auto milliseconds = [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+    std::cout << "Terrain : " << chunks.size() << " morceaux, "
+              << vertices.size() / vertexSize << " sommets construits en "
+              << milliseconds(buildEnd - buildStart) << " ms ("
+              << pool.getThreadCount() << " threads), envoi en "
+              << milliseconds(uploadEnd - buildEnd) << " ms" << std::endl;
+}
+
+Terrain::~Terrain() {
+    glDeleteVertexArrays(1, &terrainVAO);
+    glDeleteBuffers(1, &terrainVBO);
+    glDeleteBuffers(1, &terrainEBO);
+    glDeleteTextures(1, &tileTexture);
+    glDeleteTextures(1, &materialTexture);
+}
+
+// Valeur pseudo-aléatoire dans [0, 1) pour un texel d'une couche
+static float texelNoise(int x, int y, unsigned int layer) {
+    uint32_t hash = static_cast<uint32_t>(x) * 0x8da6b343u ^
+                    static_cast<uint32_t>(y) * 0xd8163841u ^
+                    (layer + 1) * 0xcb1ab31fu;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    hash ^= hash >> 15;
+    return (hash & 0xffffff) / 16777216.0f;
+}
+
+// Bruit de valeur lissé, périodique sur la couche (période de period texels)
+static float smoothTexelNoise(int x, int y, int period, unsigned int layer) {
+    const int cells = TERRAIN_MATERIAL_SIZE / period;
+    const int cellX = x / period, cellY = y / period;
+    const float u = static_cast<float>(x % period) / period;
+    const float v = static_cast<float>(y % period) / period;
+    auto corner = [&](int i, int j) {
+        return texelNoise((cellX + i) % cells, (cellY + j) % cells, layer);
+    };
+    const float top = corner(0, 0) + (corner(1, 0) - corner(0, 0)) * u;
+    const float bottom = corner(0, 1) + (corner(1, 1) - corner(0, 1)) * u;
+    return top + (bottom - top) * v;
+}
+
+// Couche de matériau générée autour de la couleur du type : taches de
+// terre, grain fin de l'asphalte, cailloux du gravier. Les couches se
+// répètent sans raccord visible.
+static void generateMaterialLayer(TerrainType type, const glm::vec3 &color,
+                                  unsigned char *out) {
+    const unsigned int layer = static_cast<unsigned int>(type);
+    for (int y = 0; y < TERRAIN_MATERIAL_SIZE; y++) {
+        for (int x = 0; x < TERRAIN_MATERIAL_SIZE; x++) {
+            const float grain = texelNoise(x, y, layer) - 0.5f;
+            float shade;
+            switch (type) {
+                case TerrainType::ROAD:
+                    shade = 1.0f + 0.08f * grain +
+                            0.05f * (smoothTexelNoise(x, y, 32, layer) - 0.5f);
+                    break;
+                case TerrainType::GRAVEL:
+                    // Cailloux : quelques texels nettement plus clairs ou
+                    // plus sombres
+                    shade = 1.0f + (std::abs(grain) > 0.4f ? 2.0f * grain
+                                                           : 0.1f * grain);
+                    break;
+                default:
+                    shade = 0.8f + 0.4f * smoothTexelNoise(x, y, 16, layer) +
+                            0.15f * grain;
+                    break;
+            }
+            const glm::vec3 texel =
+                glm::clamp(color * shade, glm::vec3(0.0f), glm::vec3(1.0f));
+            *out++ = static_cast<unsigned char>(texel.r * 255.0f);
+            *out++ = static_cast<unsigned char>(texel.g * 255.0f);
+            *out++ = static_cast<unsigned char>(texel.b * 255.0f);
+            *out++ = 255;
+        }
+    }
+}
+
+void Terrain::createTextures(const Map &map) {
+    // Types des cases : TerrainType tient sur un octet, la région lue
+    // s'envoie telle quelle
+    static_assert(sizeof(TerrainType) == 1, "");
+    std::vector<TerrainType> types(static_cast<size_t>(mapWidth) * mapDepth);
+    map.getTerrainRegion(0, 0, mapWidth, mapDepth, types.data());
+
+    glGenTextures(1, &tileTexture);
+    glBindTexture(GL_TEXTURE_2D, tileTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, mapWidth, mapDepth, 0,
+                 GL_RED_INTEGER, GL_UNSIGNED_BYTE, types.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // Texture entière : lue avec texelFetch, sans filtrage
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Une couche de matériau par type de case
+    const TerrainType layers[] = {TerrainType::DIRT, TerrainType::ROAD,
+                                  TerrainType::GRAVEL};
+    const size_t layerSize =
+        static_cast<size_t>(TERRAIN_MATERIAL_SIZE) * TERRAIN_MATERIAL_SIZE * 4;
+    std::vector<unsigned char> texels(layerSize * 3);
+    for (TerrainType type : layers) {
+        generateMaterialLayer(type, map.getTerrainColor(type),
+                              &texels[static_cast<size_t>(type) * layerSize]);
+    }
+
+    glGenTextures(1, &materialTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, materialTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, TERRAIN_MATERIAL_SIZE,
+                 TERRAIN_MATERIAL_SIZE, 3, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 texels.data());
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                    GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void Terrain::buildChunk(const Map &map, size_t chunkIndex,
+                         unsigned char *vertices) {
+    TerrainChunk &chunk = chunks[chunkIndex];
+    const int startX =
+        static_cast<int>(chunkIndex / chunksZ) * TERRAIN_CHUNK_SIZE;
+    const int startZ =
+        static_cast<int>(chunkIndex % chunksZ) * TERRAIN_CHUNK_SIZE;
+    const int endX = std::min(startX + TERRAIN_CHUNK_SIZE, mapWidth);
+    const int endZ = std::min(startZ + TERRAIN_CHUNK_SIZE, mapDepth);
+    float minHeight = map.getGridHeight(startX, startZ);
+    float maxHeight = minHeight;
+    for (int x = startX; x <= endX; x++) {
+        for (int z = startZ; z <= endZ; z++) {
+            minHeight = std::min(minHeight, map.getGridHeight(x, z));
+            maxHeight = std::max(maxHeight, map.getGridHeight(x, z));
+        }
+    }
+    chunk.bounds.min = glm::vec3(startX, minHeight, startZ);
+    chunk.bounds.max = glm::vec3(endX, maxHeight, endZ);
+    computeLodErrors(map, chunk);
+
+    buildTerrainVertices(map, startX, startZ, TERRAIN_CHUNK_SIZE, format,
+                         heightRange, vertices);
+}
+
+int Terrain::uploadChanges(Map &map) {
+    // Un texel par case modifiée
+    if (map.hasDirtyTiles()) {
+        glBindTexture(GL_TEXTURE_2D, tileTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (const MapTile &tile : map.takeDirtyTiles()) {
+            TerrainType type = map.getTerrainAt(tile.x, tile.z);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, tile.x, tile.z, 1, 1,
+                            GL_RED_INTEGER, GL_UNSIGNED_BYTE, &type);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    if (!map.hasDirtyChunks()) {
+        return 0;
+    }
+    const size_t vertexSize = terrainVertexSize(format);
+    std::vector<unsigned char> vertices(
+        terrainGridVertexCount(TERRAIN_CHUNK_SIZE) * vertexSize);
+
+    const std::vector<MapChunk> dirtyChunks = map.takeDirtyChunks();
+    glBindBuffer(GL_ARRAY_BUFFER, terrainVBO);
+    for (const MapChunk &dirty : dirtyChunks) {
+        const size_t chunkIndex =
+            static_cast<size_t>(dirty.x) * chunksZ + dirty.z;
+        buildChunk(map, chunkIndex, vertices.data());
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        chunks[chunkIndex].baseVertex * vertexSize,
+                        vertices.size(), vertices.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return static_cast<int>(dirtyChunks.size());
+}
+
+void Terrain::computeLodErrors(const Map &map, TerrainChunk &chunk) const {
+    const int startX = static_cast<int>(chunk.bounds.min.x);
+    const int startZ = static_cast<int>(chunk.bounds.min.z);
+    auto heightAt = [&](int x, int z) {
+        return map.getGridHeight(std::min(startX + x, mapWidth),
+                                 std::min(startZ + z, mapDepth));
+    };
+
+    chunk.lodErrors[0] = 0.0f;
+    for (int lod = 1; lod < TERRAIN_LOD_COUNT; lod++) {
+        const int step = 1 << lod;
+        float error = 0.0f;
+        for (int blockX = 0; blockX < TERRAIN_CHUNK_SIZE; blockX += step) {
+            for (int blockZ = 0; blockZ < TERRAIN_CHUNK_SIZE; blockZ += step) {
+                // Coins de la case grossière, découpée selon la diagonale
+                // topLeft - bottomRight comme dans buildTerrainIndices
+                float topLeft = heightAt(blockX, blockZ);
+                float topRight = heightAt(blockX + step, blockZ);
+                float bottomRight = heightAt(blockX + step, blockZ + step);
+                float bottomLeft = heightAt(blockX, blockZ + step);
+
+                for (int x = 0; x <= step; x++) {
+                    for (int z = 0; z <= step; z++) {
+                        // Écart vertical entre le point sauté et la surface
+                        // grossière
+                        float u = static_cast<float>(x) / step;
+                        float v = static_cast<float>(z) / step;
+                        float coarse =
+                            u >= v ? topLeft + u * (topRight - topLeft) +
+                                         v * (bottomRight - topRight)
+                                   : topLeft + v * (bottomLeft - topLeft) +
+                                         u * (bottomRight - bottomLeft);
+                        error = std::max(error, std::abs(heightAt(blockX + x,
+                                                                  blockZ + z) -
+                                                         coarse));
+                    }
+                }
+            }
+        }
+        chunk.lodErrors[lod] = std::max(error, chunk.lodErrors[lod - 1]);
+    }
+}
+
+void Terrain::update(const glm::vec3 &cameraPosition, float fovY,
+                     float viewportHeight) {
+    // Une longueur l à la distance d couvre environ l * K / d pixels
+    const float K = viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+
+    for (TerrainChunk &chunk : chunks) {
+        // Distance entre la caméra et le point le plus proche du morceau
+        glm::vec3 closest =
+            glm::clamp(cameraPosition, chunk.bounds.min, chunk.bounds.max);
+        float distance = glm::length(cameraPosition - closest);
+
+        // Les erreurs croissent avec le niveau : garder le plus grossier
+        // qui respecte le budget
+        chunk.lod = 0;
+        while (chunk.lod + 1 < TERRAIN_LOD_COUNT &&
+               chunk.lodErrors[chunk.lod + 1] * K <=
+                   pixelErrorBudget * distance) {
+            chunk.lod++;
+        }
+    }
+
+    // Limiter l'écart entre morceaux voisins à un niveau : on affine les
+    // morceaux trop grossiers jusqu'à stabilisation
+    auto chunkAt = [&](int chunkX, int chunkZ) -> TerrainChunk & {
+        return chunks[chunkX * chunksZ + chunkZ];
+    };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int chunkX = 0; chunkX < chunksX; chunkX++) {
+            for (int chunkZ = 0; chunkZ < chunksZ; chunkZ++) {
+                int maxLod = TERRAIN_LOD_COUNT - 1;
+                if (chunkX > 0)
+                    maxLod = std::min(maxLod, chunkAt(chunkX - 1, chunkZ).lod + 1);
+                if (chunkX + 1 < chunksX)
+                    maxLod = std::min(maxLod, chunkAt(chunkX + 1, chunkZ).lod + 1);
+                if (chunkZ > 0)
+                    maxLod = std::min(maxLod, chunkAt(chunkX, chunkZ - 1).lod + 1);
+                if (chunkZ + 1 < chunksZ)
+                    maxLod = std::min(maxLod, chunkAt(chunkX, chunkZ + 1).lod + 1);
+
+                TerrainChunk &chunk = chunkAt(chunkX, chunkZ);
+                if (chunk.lod > maxLod) {
+                    chunk.lod = maxLod;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Raccorder les bords dont le voisin est moins détaillé
+    for (int chunkX = 0; chunkX < chunksX; chunkX++) {
+        for (int chunkZ = 0; chunkZ < chunksZ; chunkZ++) {
+            TerrainChunk &chunk = chunkAt(chunkX, chunkZ);
+            chunk.stitchedEdges = 0;
+            if (chunkX > 0 && chunkAt(chunkX - 1, chunkZ).lod > chunk.lod)
+                chunk.stitchedEdges |= EDGE_MIN_X;
+            if (chunkX + 1 < chunksX &&
+                chunkAt(chunkX + 1, chunkZ).lod > chunk.lod)
+                chunk.stitchedEdges |= EDGE_MAX_X;
+            if (chunkZ > 0 && chunkAt(chunkX, chunkZ - 1).lod > chunk.lod)
+                chunk.stitchedEdges |= EDGE_MIN_Z;
+            if (chunkZ + 1 < chunksZ &&
+                chunkAt(chunkX, chunkZ + 1).lod > chunk.lod)
+                chunk.stitchedEdges |= EDGE_MAX_Z;
+        }
+    }
+}
+
+void Terrain::sendToShader(ShaderProgram &program) const {
+    glUseProgram(program.getId());
+    program.set(program.uniform("tileTypes"), TERRAIN_TILE_TEXTURE_UNIT);
+    program.set(program.uniform("terrainMaterials"),
+                TERRAIN_MATERIAL_TEXTURE_UNIT);
+    glUseProgram(0);
+}
+
+void Terrain::bindVertexFormat(ShaderProgram &program) const {
+    const VertexFormatUniforms &uniforms = vertexFormatUniforms.get(program);
+    program.set(uniforms.compactVertices,
+                format == TerrainVertexFormat::COMPACT);
+    program.set(uniforms.packedVertices, format == TerrainVertexFormat::PACKED);
+    // Seule la hauteur est quantifiée : x et z sont déjà entiers
+    program.set(uniforms.positionScale,
+                glm::vec3(1.0f, heightRange.scale, 1.0f));
+    program.set(uniforms.positionOffset,
+                glm::vec3(0.0f, heightRange.offset, 0.0f));
+}
+
+int Terrain::render(const Frustum &frustum) const {
+    glActiveTexture(GL_TEXTURE0 + TERRAIN_TILE_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, tileTexture);
+    glActiveTexture(GL_TEXTURE0 + TERRAIN_MATERIAL_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, materialTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(terrainVAO);
+
+    int drawnChunks = 0;
+    for (const TerrainChunk &chunk : chunks) {
+        if (!frustum.intersects(chunk.bounds)) {
+            continue;
+        }
+        const IndexPattern &pattern =
+            patterns[chunk.lod * 16 + chunk.stitchedEdges];
+        glDrawElementsBaseVertex(
+            GL_TRIANGLES, pattern.indexCount, GL_UNSIGNED_SHORT,
+            (void *)(pattern.firstIndex * sizeof(TerrainIndex)),
+            chunk.baseVertex);
+        drawnChunks++;
+    }
+
+    glBindVertexArray(0);
+    return drawnChunks;
+}
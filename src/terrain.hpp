@@ -0,0 +1,151 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include "../include/glad/glad.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "frustum.hpp"
+#include "map.hpp"
+#include "shader.hpp"
+#include "terrain_mesh.hpp"
+#include "thread_pool.hpp"
+
+// Taille (en cases) d'un morceau de terrain : celle des morceaux dont la
+// carte suit les modifications
+#define TERRAIN_CHUNK_SIZE MAP_CHUNK_SIZE
+// Nombre de niveaux de détail : pas de 1, 2, 4, ... TERRAIN_CHUNK_SIZE cases
+#define TERRAIN_LOD_COUNT 6
+// Erreur maximale tolérée à l'écran (en pixels) par défaut
+#define TERRAIN_PIXEL_ERROR 2.0f
+// Unités de texture des types de case et des matériaux (0 : skybox,
+// 1 : shadow map, 2 : cubemap des reflets)
+#define TERRAIN_TILE_TEXTURE_UNIT 3
+#define TERRAIN_MATERIAL_TEXTURE_UNIT 4
+// Taille (en texels) d'une couche de matériau
+#define TERRAIN_MATERIAL_SIZE 128
+// Marge (en unités monde) ajoutée de part et d'autre des hauteurs de la
+// carte pour le format PACKED : les modifications du relief qui en sortent
+// sont ramenées sur la plage
+#define TERRAIN_PACKED_HEIGHT_MARGIN 16.0f
+
+static_assert((1 << (TERRAIN_LOD_COUNT - 1)) == TERRAIN_CHUNK_SIZE,
+              "TERRAIN_LOD_COUNT doit valoir log2(TERRAIN_CHUNK_SIZE) + 1");
+// Les indices d'un morceau sont relatifs à son premier sommet : ils tiennent
+// sur 16 bits (GL_UNSIGNED_SHORT) quelle que soit la taille de la carte
+static_assert(terrainGridVertexCount(TERRAIN_CHUNK_SIZE) <= UINT16_MAX + 1,
+              "Morceau de terrain trop grand pour des indices 16 bits");
+
+// Terrain découpé en morceaux de TERRAIN_CHUNK_SIZE x TERRAIN_CHUNK_SIZE
+// cases. Chaque morceau possède son bloc de sommets (un sommet partagé par
+// point de la grille) et sa boîte englobante ; les motifs d'indices (un par
+// niveau de détail et par combinaison de bords raccordés) sont communs à
+// tous les morceaux, sur 16 bits, et dessinés avec glDrawElementsBaseVertex.
+// Seuls les morceaux visibles depuis la caméra (ou la lumière pour la shadow
+// map) sont dessinés.
+//
+// Niveaux de détail (geomipmapping) : pour chaque morceau et chaque niveau,
+// on précalcule l'erreur géométrique commise en sautant des points. update()
+// choisit le niveau le plus grossier dont l'erreur projetée à l'écran reste
+// sous le budget en pixels, puis limite l'écart entre voisins à un niveau
+// pour que les raccords restent sans fissure.
+//
+// Les morceaux sont construits en parallèle sur le ThreadPool fourni, chacun
+// dans sa tranche du tampon de sommets final. Les modifications de relief
+// (setGridHeight) ne renvoient au GPU que les morceaux touchés.
+//
+// Les sommets ne portent pas de couleur : le fragment shader lit le type de
+// chaque case dans une texture entière (un texel par case) et l'aspect de
+// chaque type dans une couche d'un tableau de textures de matériaux.
+// Changer le type d'une case (setTerrainAt) ne renvoie qu'un texel.
+class Terrain {
+  public:
+    Terrain(const Map &map, ThreadPool &pool,
+            TerrainVertexFormat format = TerrainVertexFormat::PACKED);
+    ~Terrain();
+
+    // Envoyer au shader du terrain les unités de ses textures (à faire une
+    // fois après la création du programme)
+    void sendToShader(ShaderProgram &program) const;
+
+    // Envoyer au programme actif (terrain ou shadow map) de quoi décoder les
+    // sommets du format choisi. À appeler avant render().
+    void bindVertexFormat(ShaderProgram &program) const;
+
+    // Choisir le niveau de détail de chaque morceau pour une caméra placée en
+    // cameraPosition (fovY en radians, hauteur de la fenêtre en pixels)
+    void update(const glm::vec3 &cameraPosition, float fovY,
+                float viewportHeight);
+
+    // Appliquer les modifications de la carte depuis le dernier appel : les
+    // morceaux dont le relief a changé sont reconstruits (sommets, boîte
+    // englobante, erreurs des niveaux de détail) et seule leur tranche du VBO
+    // est renvoyée ; chaque case modifiée renvoie un texel. À appeler avant
+    // de dessiner l'image. Renvoie le nombre de morceaux mis à jour.
+    int uploadChanges(Map &map);
+
+    // Dessiner les morceaux qui intersectent le frustum. Le shader doit déjà
+    // être actif ; les textures du terrain sont liées à leurs unités.
+    // Renvoie le nombre de morceaux dessinés.
+    int render(const Frustum &frustum) const;
+
+    void setPixelErrorBudget(float pixels) { pixelErrorBudget = pixels; }
+    float getPixelErrorBudget() const { return pixelErrorBudget; }
+
+    int getChunkCount() const { return static_cast<int>(chunks.size()); }
+    TerrainVertexFormat getVertexFormat() const { return format; }
+
+  private:
+    struct TerrainChunk {
+        AABB bounds;
+        int baseVertex; // Premier sommet du morceau dans le VBO
+        // Erreur géométrique (en unités monde) de chaque niveau de détail,
+        // croissante avec le niveau
+        float lodErrors[TERRAIN_LOD_COUNT];
+        int lod;
+        unsigned int stitchedEdges;
+    };
+
+    // Plage de l'EBO d'un motif d'indices
+    struct IndexPattern {
+        unsigned int firstIndex;
+        unsigned int indexCount;
+    };
+
+    TerrainVertexFormat format;
+    TerrainHeightRange heightRange; // Hauteurs du format PACKED
+
+    // Uniformes de décodage des sommets d'un programme
+    struct VertexFormatUniforms {
+        UniformHandle compactVertices, packedVertices, positionScale,
+            positionOffset;
+
+        explicit VertexFormatUniforms(ShaderProgram &program)
+            : compactVertices(program.uniform("compactVertices")),
+              packedVertices(program.uniform("packedVertices")),
+              positionScale(program.uniform("positionScale")),
+              positionOffset(program.uniform("positionOffset")) {}
+    };
+    // Pour chaque programme passé à bindVertexFormat
+    mutable UniformCache<VertexFormatUniforms> vertexFormatUniforms;
+    int mapWidth, mapDepth;
+    int chunksX, chunksZ; // Nombre de morceaux en x et en z
+    std::vector<TerrainChunk> chunks;
+    // patterns[lod * 16 + stitchedEdges]
+    std::vector<IndexPattern> patterns;
+    float pixelErrorBudget;
+    unsigned int terrainVAO, terrainVBO, terrainEBO;
+    // Types des cases (GL_R8UI, mapWidth x mapDepth) et matériaux
+    // (GL_TEXTURE_2D_ARRAY, une couche par TerrainType)
+    unsigned int tileTexture, materialTexture;
+
+    // Calculer la boîte englobante et les erreurs d'un morceau et écrire ses
+    // sommets dans vertices
+    void buildChunk(const Map &map, size_t chunkIndex,
+                    unsigned char *vertices);
+    void computeLodErrors(const Map &map, TerrainChunk &chunk) const;
+    void createTextures(const Map &map);
+};
+
+#endif
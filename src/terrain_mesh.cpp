@@ -0,0 +1,131 @@
+#include "terrain_mesh.hpp"
+
+#include "../include/glad/glad.h"
+#include <algorithm>
+
+#include "vertex_packing.hpp"
+
+size_t terrainVertexSize(TerrainVertexFormat format) {
+    switch (format) {
+    case TerrainVertexFormat::FULL:
+        return sizeof(FullTerrainVertex);
+    case TerrainVertexFormat::PACKED:
+        return sizeof(PackedTerrainVertex);
+    default:
+        return sizeof(CompactTerrainVertex);
+    }
+}
+
+void buildTerrainVertices(const Map &map, int startX, int startZ, int cells,
+                          TerrainVertexFormat format,
+                          const TerrainHeightRange &heightRange,
+                          unsigned char *out) {
+    for (int i = 0; i <= cells; i++) {
+        for (int j = 0; j <= cells; j++) {
+            // Point de la grille, ramené sur le bord de la carte si besoin
+            int x = std::min(startX + i, map.getWidth());
+            int z = std::min(startZ + j, map.getDepth());
+
+            const float yPos = map.getGridHeight(x, z);
+            if (format == TerrainVertexFormat::FULL) {
+                FullTerrainVertex *vertex =
+                    reinterpret_cast<FullTerrainVertex *>(out);
+                glm::vec3 normal = map.getGridNormal(x, z);
+                *vertex = {{static_cast<float>(x), yPos, static_cast<float>(z)},
+                           {normal.x, normal.y, normal.z}};
+            } else if (format == TerrainVertexFormat::PACKED) {
+                PackedTerrainVertex *vertex =
+                    reinterpret_cast<PackedTerrainVertex *>(out);
+                vertex->position[0] = static_cast<uint16_t>(x);
+                vertex->position[1] = quantizeUint16(yPos, heightRange.offset,
+                                                     heightRange.scale);
+                vertex->position[2] = static_cast<uint16_t>(z);
+                packOctahedralNormal(map.getGridNormal(x, z), vertex->normal);
+                vertex->padding = 0;
+            } else {
+                CompactTerrainVertex *vertex =
+                    reinterpret_cast<CompactTerrainVertex *>(out);
+                *vertex = {{static_cast<float>(x), yPos, static_cast<float>(z)}};
+            }
+            out += terrainVertexSize(format);
+        }
+    }
+}
+
+void buildTerrainIndices(int cells, std::vector<TerrainIndex> &indices,
+                         int step, unsigned int stitchedEdges) {
+    const unsigned int rowLength = cells + 1;
+    const int coarseStep = 2 * step;
+    indices.reserve(indices.size() +
+                    static_cast<size_t>(cells / step) * (cells / step) * 6);
+
+    // Indice du point (x, z), raccordé au voisin le cas échéant
+    auto gridIndex = [&](int x, int z) {
+        if (((stitchedEdges & EDGE_MIN_X) && x == 0) ||
+            ((stitchedEdges & EDGE_MAX_X) && x == cells)) {
+            z -= z % coarseStep;
+        }
+        if (((stitchedEdges & EDGE_MIN_Z) && z == 0) ||
+            ((stitchedEdges & EDGE_MAX_Z) && z == cells)) {
+            x -= x % coarseStep;
+        }
+        return static_cast<TerrainIndex>(x * rowLength + z);
+    };
+    auto addTriangle = [&](TerrainIndex a, TerrainIndex b, TerrainIndex c) {
+        if (a == b || b == c || a == c) {
+            return; // Triangle dégénéré par le raccord
+        }
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    };
+
+    for (int x = 0; x < cells; x += step) {
+        for (int z = 0; z < cells; z += step) {
+            TerrainIndex topLeft = gridIndex(x, z);
+            TerrainIndex topRight = gridIndex(x + step, z);
+            TerrainIndex bottomRight = gridIndex(x + step, z + step);
+            TerrainIndex bottomLeft = gridIndex(x, z + step);
+
+            // Deux triangles par case, de même sens de rotation, qui
+            // partagent la diagonale topLeft - bottomRight
+            addTriangle(topRight, bottomRight, topLeft);
+            addTriangle(bottomRight, bottomLeft, topLeft);
+        }
+    }
+}
+
+void setupTerrainVertexAttributes(TerrainVertexFormat format) {
+    if (format == TerrainVertexFormat::FULL) {
+        // Attributs du sommet (Position)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(FullTerrainVertex),
+                              (void *)offsetof(FullTerrainVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // Attributs du sommet (Normale)
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(FullTerrainVertex),
+                              (void *)offsetof(FullTerrainVertex, normal));
+        glEnableVertexAttribArray(2);
+    } else if (format == TerrainVertexFormat::PACKED) {
+        // Attributs du sommet (Position, entiers remis à l'échelle par le
+        // shader)
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE,
+                              sizeof(PackedTerrainVertex),
+                              (void *)offsetof(PackedTerrainVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // Attributs du sommet (Normale octaédrique, lue dans [-1, 1])
+        glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE,
+                              sizeof(PackedTerrainVertex),
+                              (void *)offsetof(PackedTerrainVertex, normal));
+        glEnableVertexAttribArray(2);
+    } else {
+        // Attributs du sommet (Position)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(CompactTerrainVertex),
+                              (void *)offsetof(CompactTerrainVertex, position));
+        glEnableVertexAttribArray(0);
+    }
+}
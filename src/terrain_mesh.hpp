@@ -0,0 +1,89 @@
+#ifndef TERRAIN_MESH_H
+#define TERRAIN_MESH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "map.hpp"
+
+// Format des sommets du terrain. La couleur n'est dans aucun des deux : le
+// fragment shader la lit dans les textures du terrain (voir Terrain).
+enum class TerrainVertexFormat {
+    FULL,    // Position et normale : 6 floats (24 octets)
+    COMPACT, // Position seule (12 octets)
+    PACKED   // Position sur 16 bits et normale octaédrique (12 octets)
+};
+
+struct FullTerrainVertex {
+    float position[3];
+    float normal[3];
+};
+
+// La normale n'est pas stockée : le fragment shader la déduit des dérivées
+// de la position (éclairage par facette).
+struct CompactTerrainVertex {
+    float position[3];
+};
+
+// x et z sont les coordonnées entières du point de la grille ; y est la
+// hauteur quantifiée dans la plage de hauteurs du terrain (voir
+// TerrainHeightRange). La normale est dépliée sur un octaèdre (voir
+// vertex_packing.hpp).
+struct PackedTerrainVertex {
+    uint16_t position[3];
+    int16_t normal[2];
+    uint16_t padding;
+};
+
+// Plage des hauteurs représentables par le format PACKED :
+// y = q * scale + offset, q entier de 16 bits
+struct TerrainHeightRange {
+    float offset;
+    float scale;
+};
+
+// Taille en octets d'un sommet du format donné
+size_t terrainVertexSize(TerrainVertexFormat format);
+
+// Nombre de sommets d'une grille de cells x cells cases : un sommet partagé
+// par point de la grille.
+constexpr size_t terrainGridVertexCount(int cells) {
+    return static_cast<size_t>(cells + 1) * (cells + 1);
+}
+
+// Écrire dans out les (cells + 1)^2 sommets de la zone qui commence à la case
+// (startX, startZ). Les points hors de la carte sont ramenés sur son bord, ce
+// qui rend dégénérés les triangles des morceaux incomplets. heightRange
+// n'est utilisée que par le format PACKED ; les hauteurs qui en sortent
+// sont ramenées sur ses bornes.
+void buildTerrainVertices(const Map &map, int startX, int startZ, int cells,
+                          TerrainVertexFormat format,
+                          const TerrainHeightRange &heightRange,
+                          unsigned char *out);
+
+// Indice d'un sommet dans sa zone : 16 bits suffisent tant qu'une zone a
+// moins de 65536 sommets (voir Terrain)
+typedef uint16_t TerrainIndex;
+
+// Bords d'une zone, pour raccorder une zone à un voisin moins détaillé
+enum TerrainEdge {
+    EDGE_MIN_X = 1 << 0,
+    EDGE_MAX_X = 1 << 1,
+    EDGE_MIN_Z = 1 << 2,
+    EDGE_MAX_Z = 1 << 3
+};
+
+// Indices d'une grille de cells x cells cases, relatifs au premier sommet de
+// la zone (à dessiner avec glDrawElementsBaseVertex). Seul un point sur step
+// est utilisé (niveau de détail). Sur les bords de stitchedEdges, le voisin
+// utilise un pas de 2 * step : les points intermédiaires du bord sont
+// ramenés sur le point précédent, ce qui supprime les fissures (les
+// triangles devenus dégénérés ne sont pas émis).
+void buildTerrainIndices(int cells, std::vector<TerrainIndex> &indices,
+                         int step = 1, unsigned int stitchedEdges = 0);
+
+// Déclarer les attributs de sommet du format dans le VAO actuellement lié
+void setupTerrainVertexAttributes(TerrainVertexFormat format);
+
+#endif
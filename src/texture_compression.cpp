@@ -0,0 +1,182 @@
+#include "texture_compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+size_t bc1Size(int width, int height) {
+    const size_t blocksX = static_cast<size_t>(std::max(1, (width + 3) / 4));
+    const size_t blocksY = static_cast<size_t>(std::max(1, (height + 3) / 4));
+    return blocksX * blocksY * BC1_BLOCK_BYTES;
+}
+
+// Couleur RGB8 arrondie au RGB565 le plus proche
+static uint16_t toRGB565(const float color[3]) {
+    auto quantize = [](float value, int max) {
+        const float clamped = std::min(std::max(value, 0.0f), 255.0f);
+        return static_cast<int>(clamped * max / 255.0f + 0.5f);
+    };
+    return static_cast<uint16_t>((quantize(color[0], 31) << 11) |
+                                 (quantize(color[1], 63) << 5) |
+                                 quantize(color[2], 31));
+}
+
+// Couleur RGB8 décodée par le GPU à partir d'une couleur RGB565
+static void fromRGB565(uint16_t packed, int color[3]) {
+    const int r = (packed >> 11) & 31;
+    const int g = (packed >> 5) & 63;
+    const int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// Encoder un bloc de 16 pixels RGB
+static void encodeBlock(const float pixels[16][3], unsigned char *out) {
+    // Moyenne et covariance des couleurs du bloc
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += pixels[i][c] / 16.0f;
+        }
+    }
+    float covariance[3][3] = {};
+    for (int i = 0; i < 16; i++) {
+        float d[3];
+        for (int c = 0; c < 3; c++) {
+            d[c] = pixels[i][c] - mean[c];
+        }
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                covariance[a][b] += d[a] * d[b];
+            }
+        }
+    }
+
+    // Axe principal par itérations de la puissance, en partant de la
+    // diagonale du cube des couleurs
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[3];
+        for (int a = 0; a < 3; a++) {
+            next[a] = covariance[a][0] * axis[0] + covariance[a][1] * axis[1] +
+                      covariance[a][2] * axis[2];
+        }
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] +
+                                       next[2] * next[2]);
+        if (length < 1e-6f) {
+            break; // Bloc uni : l'axe importe peu
+        }
+        for (int a = 0; a < 3; a++) {
+            axis[a] = next[a] / length;
+        }
+    }
+
+    // Extrémités : couleurs du bloc dont la projection sur l'axe est
+    // minimale et maximale
+    float minProjection = 0.0f, maxProjection = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        const float projection = (pixels[i][0] - mean[0]) * axis[0] +
+                                 (pixels[i][1] - mean[1]) * axis[1] +
+                                 (pixels[i][2] - mean[2]) * axis[2];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    float high[3], low[3];
+    for (int c = 0; c < 3; c++) {
+        high[c] = mean[c] + axis[c] * maxProjection;
+        low[c] = mean[c] + axis[c] * minProjection;
+    }
+    uint16_t color0 = toRGB565(high);
+    uint16_t color1 = toRGB565(low);
+    // color0 > color1 : mode opaque à quatre couleurs
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[4][3];
+        fromRGB565(color0, palette[0]);
+        fromRGB565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            float bestDistance = INFINITY;
+            for (int p = 0; p < 4; p++) {
+                float distance = 0.0f;
+                for (int c = 0; c < 3; c++) {
+                    const float d = pixels[i][c] - palette[p][c];
+                    distance += d * d;
+                }
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+    // Sinon (une seule couleur) tous les indices désignent color0
+
+    // Petit-boutiste, comme le lit le GPU
+    out[0] = color0 & 0xff;
+    out[1] = color0 >> 8;
+    out[2] = color1 & 0xff;
+    out[3] = color1 >> 8;
+    for (int i = 0; i < 4; i++) {
+        out[4 + i] = (indices >> (8 * i)) & 0xff;
+    }
+}
+
+void encodeBC1(const unsigned char *rgba, int width, int height,
+               unsigned char *blocks) {
+    const int blocksX = std::max(1, (width + 3) / 4);
+    const int blocksY = std::max(1, (height + 3) / 4);
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            float pixels[16][3];
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    const int sx = std::min(bx * 4 + x, width - 1);
+                    const int sy = std::min(by * 4 + y, height - 1);
+                    const unsigned char *pixel =
+                        rgba + (static_cast<size_t>(sy) * width + sx) * 4;
+                    for (int c = 0; c < 3; c++) {
+                        pixels[y * 4 + x][c] = pixel[c];
+                    }
+                }
+            }
+            encodeBlock(pixels, blocks + (static_cast<size_t>(by) * blocksX +
+                                          bx) * BC1_BLOCK_BYTES);
+        }
+    }
+}
+
+void downsampleRGBA(const unsigned char *rgba, int width, int height,
+                    std::vector<unsigned char> &out) {
+    const int outWidth = std::max(1, width / 2);
+    const int outHeight = std::max(1, height / 2);
+    out.resize(static_cast<size_t>(outWidth) * outHeight * 4);
+    for (int y = 0; y < outHeight; y++) {
+        const int y0 = std::min(2 * y, height - 1);
+        const int y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < outWidth; x++) {
+            const int x0 = std::min(2 * x, width - 1);
+            const int x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < 4; c++) {
+                auto at = [&](int px, int py) {
+                    return rgba[(static_cast<size_t>(py) * width + px) * 4 + c];
+                };
+                out[(static_cast<size_t>(y) * outWidth + x) * 4 + c] =
+                    static_cast<unsigned char>(
+                        (at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1) +
+                         2) /
+                        4);
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#include <cstddef>
+#include <vector>
+
+// Compression BC1 (DXT1) sur le CPU. Chaque bloc de 4 x 4 pixels garde deux
+// couleurs RGB565, les extrémités du segment qui suit l'axe principal des
+// couleurs du bloc, et un indice de 2 bits par pixel vers l'une des quatre
+// couleurs interpolées : 8 octets pour 16 pixels (6 fois moins que RGB8).
+
+// Taille d'un bloc BC1 en octets
+#define BC1_BLOCK_BYTES 8
+
+// Taille en octets d'une image BC1 de width x height pixels
+size_t bc1Size(int width, int height);
+
+// Encoder une image RGBA8 (l'alpha est ignoré) en blocs BC1 opaques, ligne
+// de blocs par ligne de blocs. Les blocs du bord droit et du bord bas sont
+// complétés en répétant les derniers pixels. blocks doit contenir
+// bc1Size(width, height) octets.
+void encodeBC1(const unsigned char *rgba, int width, int height,
+               unsigned char *blocks);
+
+// Niveau de mipmap suivant d'une image RGBA8 : moyenne de chaque carré de
+// 2 x 2 pixels (une dimension de 1 le reste)
+void downsampleRGBA(const unsigned char *rgba, int width, int height,
+                    std::vector<unsigned char> &out);
+
+#endif
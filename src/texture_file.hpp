@@ -0,0 +1,56 @@
+#ifndef TEXTURE_FILE_H
+#define TEXTURE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Format binaire des textures précalculées (.btex), écrit au premier
+// chargement d'une image et projeté en mémoire aux lancements suivants, sur
+// le modèle des conteneurs KTX2 : un en-tête, une table des niveaux puis
+// les blocs compressés de chaque niveau, tels qu'envoyés au GPU.
+//
+//   TextureFileHeader
+//   niveaux : levelCount x TextureFileLevel, du niveau 0 (pleine taille) au
+//             niveau 1 x 1
+//   blocs   : ceux de chaque niveau, ligne de blocs par ligne de blocs
+//
+// Chaque tableau commence sur une frontière de TEXTURE_FILE_ALIGNMENT
+// octets. sourceHash est le hachage FNV-1a de l'image source : s'il ne
+// correspond plus, le fichier est recalculé.
+
+#define TEXTURE_FILE_MAGIC "OGLT"
+#define TEXTURE_FILE_VERSION 1
+#define TEXTURE_FILE_ALIGNMENT 16
+// Extension ajoutée au chemin de l'image source
+#define TEXTURE_FILE_EXTENSION ".btex"
+// Taille maximale d'une texture (largeur ou hauteur)
+#define TEXTURE_MAX_SIZE 16384
+
+// Format des blocs
+enum class TextureFileFormat : uint32_t {
+    BC1 = 1 // Blocs de 4 x 4 pixels RGB sur 8 octets (DXT1, opaque)
+};
+
+struct TextureFileHeader {
+    char magic[4]; // TEXTURE_FILE_MAGIC
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t format; // TextureFileFormat
+    uint32_t width;  // Taille du niveau 0 en pixels
+    uint32_t height;
+    uint32_t levelCount;
+    uint64_t levelOffset; // Position de la table des niveaux
+};
+
+// Niveau de mipmap : taille en pixels et plage de ses blocs dans le fichier
+struct TextureFileLevel {
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(TextureFileHeader) == 40, "En-tête de texture mal aligné");
+static_assert(sizeof(TextureFileLevel) == 24, "Niveau de texture mal aligné");
+
+#endif
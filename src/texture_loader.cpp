@@ -0,0 +1,324 @@
+#include "texture_loader.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb/stb_image.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+#include "binary_writer.hpp"
+#include "gl_extensions.hpp"
+#include "hash.hpp"
+#include "texture_compression.hpp"
+#include "texture_file.hpp"
+
+void PreparedTexture::ImageDeleter::operator()(unsigned char *pixels) const {
+    stbi_image_free(pixels);
+}
+
+// Nombre de niveaux de la chaîne de mipmaps complète
+static int mipLevelCount(int width, int height) {
+    int levels = 1;
+    while ((std::max(width, height) >> levels) > 0) {
+        levels++;
+    }
+    return levels;
+}
+
+static std::shared_ptr<PreparedTexture> emptyTexture(bool compressed) {
+    auto image = std::make_shared<PreparedTexture>();
+    image->width = image->height = 0;
+    image->compressed = compressed;
+    image->format = image->internalFormat =
+        compressed ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGBA;
+    return image;
+}
+
+// Projeter et valider une texture précalculée. nullptr si le fichier
+// manque, est invalide ou ne correspond plus à sourceHash.
+static std::shared_ptr<PreparedTexture>
+loadBakedTexture(const std::string &path, uint64_t sourceHash) {
+    auto image = emptyTexture(true);
+    FileData &file = image->file;
+    if (!VirtualFileSystem::get().read(path, file) ||
+        file.size() < sizeof(TextureFileHeader)) {
+        return nullptr; // Pas encore précalculée
+    }
+
+    const TextureFileHeader *header =
+        reinterpret_cast<const TextureFileHeader *>(file.data());
+    if (!std::equal(header->magic, header->magic + 4, TEXTURE_FILE_MAGIC) ||
+        header->version != TEXTURE_FILE_VERSION ||
+        header->sourceHash != sourceHash ||
+        header->format != static_cast<uint32_t>(TextureFileFormat::BC1)) {
+        return nullptr; // Format ancien ou source modifiée
+    }
+
+    // Chaque niveau doit avoir la taille attendue et tenir dans le fichier
+    auto validArray = [&](uint64_t offset, size_t bytes) {
+        return offset % TEXTURE_FILE_ALIGNMENT == 0 && offset <= file.size() &&
+               bytes <= file.size() - offset;
+    };
+    const int width = static_cast<int>(header->width);
+    const int height = static_cast<int>(header->height);
+    if (header->width == 0 || header->height == 0 ||
+        header->width > TEXTURE_MAX_SIZE ||
+        header->height > TEXTURE_MAX_SIZE ||
+        header->levelCount != static_cast<uint32_t>(
+                                  mipLevelCount(width, height)) ||
+        !validArray(header->levelOffset,
+                    header->levelCount * sizeof(TextureFileLevel))) {
+        std::cerr << "Erreur : Texture précalculée tronquée ou corrompue : "
+                  << path << std::endl;
+        return nullptr;
+    }
+    const TextureFileLevel *levels = reinterpret_cast<const TextureFileLevel *>(
+        file.data() + header->levelOffset);
+    for (uint32_t i = 0; i < header->levelCount; i++) {
+        const int levelWidth = std::max(1, width >> i);
+        const int levelHeight = std::max(1, height >> i);
+        if (levels[i].width != static_cast<uint32_t>(levelWidth) ||
+            levels[i].height != static_cast<uint32_t>(levelHeight) ||
+            levels[i].size != bc1Size(levelWidth, levelHeight) ||
+            !validArray(levels[i].offset, levels[i].size)) {
+            std::cerr << "Erreur : Niveau de texture invalide : " << path
+                      << std::endl;
+            return nullptr;
+        }
+        // Les pages projetées seront copiées directement dans la texture
+        image->levels.push_back({file.data() + levels[i].offset,
+                                 static_cast<size_t>(levels[i].size),
+                                 levelWidth, levelHeight});
+    }
+    image->width = width;
+    image->height = height;
+    return image;
+}
+
+// Écrire les niveaux compressés d'une texture au format précalculé
+static bool saveBakedTexture(const std::string &path,
+                             const PreparedTexture &image,
+                             uint64_t sourceHash) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Erreur : Impossible d'écrire la texture précalculée : "
+                  << path << std::endl;
+        return false;
+    }
+
+    auto align = [](uint64_t offset) {
+        return alignOffset(offset, TEXTURE_FILE_ALIGNMENT);
+    };
+    TextureFileHeader header = {};
+    std::copy(TEXTURE_FILE_MAGIC, TEXTURE_FILE_MAGIC + 4, header.magic);
+    header.version = TEXTURE_FILE_VERSION;
+    header.sourceHash = sourceHash;
+    header.format = static_cast<uint32_t>(TextureFileFormat::BC1);
+    header.width = static_cast<uint32_t>(image.width);
+    header.height = static_cast<uint32_t>(image.height);
+    header.levelCount = static_cast<uint32_t>(image.levels.size());
+    header.levelOffset = align(sizeof(TextureFileHeader));
+
+    std::vector<TextureFileLevel> levels(image.levels.size());
+    uint64_t offset =
+        align(header.levelOffset + levels.size() * sizeof(TextureFileLevel));
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i].width = static_cast<uint32_t>(image.levels[i].width);
+        levels[i].height = static_cast<uint32_t>(image.levels[i].height);
+        levels[i].offset = offset;
+        levels[i].size = image.levels[i].size;
+        offset = align(offset + image.levels[i].size);
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeAt(file, header.levelOffset, levels.data(),
+            levels.size() * sizeof(TextureFileLevel));
+    for (size_t i = 0; i < levels.size(); i++) {
+        writeAt(file, levels[i].offset, image.levels[i].data,
+                image.levels[i].size);
+    }
+
+    if (!file) {
+        std::cerr << "Erreur : Écriture incomplète de la texture précalculée : "
+                  << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Décoder une image (JPEG, PNG...) lue en mémoire
+static unsigned char *decodeImage(const FileData &source, int &width,
+                                  int &height, int &channels,
+                                  int requestedChannels) {
+    if (source.size() > INT32_MAX) {
+        return nullptr;
+    }
+    return stbi_load_from_memory(source.data(),
+                                 static_cast<int>(source.size()), &width,
+                                 &height, &channels, requestedChannels);
+}
+
+// Décoder l'image path et compresser toute sa chaîne de mipmaps en BC1
+static std::shared_ptr<PreparedTexture>
+compressTexture(const std::string &path, const FileData &source) {
+    int width, height, channels;
+    std::unique_ptr<unsigned char, PreparedTexture::ImageDeleter> pixels(
+        decodeImage(source, width, height, channels, 4));
+    if (!pixels) {
+        std::cerr << "Erreur : Impossible de charger l'image : " << path
+                  << std::endl;
+        return nullptr;
+    }
+    if (width > TEXTURE_MAX_SIZE || height > TEXTURE_MAX_SIZE) {
+        std::cerr << "Erreur : Image trop grande : " << path << std::endl;
+        return nullptr;
+    }
+
+    auto image = emptyTexture(true);
+    image->width = width;
+    image->height = height;
+    const int levelCount = mipLevelCount(width, height);
+    size_t totalSize = 0;
+    for (int i = 0; i < levelCount; i++) {
+        totalSize += bc1Size(std::max(1, width >> i), std::max(1, height >> i));
+    }
+    image->blocks.resize(totalSize);
+
+    // Chaque niveau est réduit à partir du précédent, puis compressé
+    std::vector<unsigned char> level, nextLevel;
+    const unsigned char *levelPixels = pixels.get();
+    size_t offset = 0;
+    for (int i = 0; i < levelCount; i++) {
+        const int levelWidth = std::max(1, width >> i);
+        const int levelHeight = std::max(1, height >> i);
+        if (i > 0) {
+            downsampleRGBA(levelPixels, std::max(1, width >> (i - 1)),
+                           std::max(1, height >> (i - 1)), nextLevel);
+            level.swap(nextLevel);
+            levelPixels = level.data();
+        }
+        const size_t size = bc1Size(levelWidth, levelHeight);
+        encodeBC1(levelPixels, levelWidth, levelHeight,
+                  image->blocks.data() + offset);
+        image->levels.push_back(
+            {image->blocks.data() + offset, size, levelWidth, levelHeight});
+        offset += size;
+    }
+    return image;
+}
+
+std::shared_ptr<PreparedTexture> prepareTexture(const std::string &path,
+                                                bool compressed) {
+    // Image source, lue une seule fois pour le hachage et le décodage
+    FileData source;
+    const bool found = VirtualFileSystem::get().read(path, source);
+
+    if (!compressed) {
+        int width, height, channels;
+        std::unique_ptr<unsigned char, PreparedTexture::ImageDeleter> pixels(
+            found ? decodeImage(source, width, height, channels, 0) : nullptr);
+        if (!pixels) {
+            std::cerr << "Erreur : Impossible de charger l'image : " << path
+                      << std::endl;
+            return nullptr;
+        }
+        const GLenum formats[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+        const GLenum internalFormats[4] = {GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+        auto image = emptyTexture(false);
+        image->width = width;
+        image->height = height;
+        image->format = formats[channels - 1];
+        image->internalFormat = internalFormats[channels - 1];
+        image->levels.push_back(
+            {pixels.get(),
+             static_cast<size_t>(width) * height * channels, width, height});
+        image->pixels = std::move(pixels);
+        return image;
+    }
+
+    // Texture précalculée encore à jour : l'image n'est pas décodée
+    const std::string bakedPath = path + TEXTURE_FILE_EXTENSION;
+    if (!found) {
+        std::cerr << "Erreur : Impossible de charger l'image : " << path
+                  << std::endl;
+        return nullptr;
+    }
+    const uint64_t sourceHash = fnv1a(source.data(), source.size());
+    std::shared_ptr<PreparedTexture> image =
+        loadBakedTexture(bakedPath, sourceHash);
+    if (image) {
+        return image;
+    }
+
+    image = compressTexture(path, source);
+    if (image) {
+        saveBakedTexture(bakedPath, *image, sourceHash);
+    }
+    return image;
+}
+
+// Allouer la texture liée à target puis envoyer chaque niveau de chaque
+// image (une par cible de imageTargets)
+static void uploadImages(GLenum target, unsigned int texture,
+                         const GLenum *imageTargets,
+                         const PreparedTexture *const *images, int count) {
+    const PreparedTexture &first = *images[0];
+    const int levelCount = mipLevelCount(first.width, first.height);
+
+    glBindTexture(target, texture);
+    // Lignes de pixels non alignées sur 4 octets
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (glTexStorage2DExt) {
+        // Stockage immuable : toute la chaîne allouée en une fois
+        glTexStorage2DExt(target, levelCount, first.internalFormat,
+                          first.width, first.height);
+    }
+    for (int i = 0; i < count; i++) {
+        const PreparedTexture &image = *images[i];
+        for (size_t l = 0; l < image.levels.size(); l++) {
+            const TextureLevel &level = image.levels[l];
+            const GLint mip = static_cast<GLint>(l);
+            if (image.compressed && glTexStorage2DExt) {
+                glCompressedTexSubImage2D(
+                    imageTargets[i], mip, 0, 0, level.width, level.height,
+                    image.format, static_cast<GLsizei>(level.size), level.data);
+            } else if (image.compressed) {
+                glCompressedTexImage2D(imageTargets[i], mip,
+                                       image.internalFormat, level.width,
+                                       level.height, 0,
+                                       static_cast<GLsizei>(level.size),
+                                       level.data);
+            } else if (glTexStorage2DExt) {
+                glTexSubImage2D(imageTargets[i], mip, 0, 0, level.width,
+                                level.height, image.format, GL_UNSIGNED_BYTE,
+                                level.data);
+            } else {
+                glTexImage2D(imageTargets[i], mip, image.internalFormat,
+                             level.width, level.height, 0, image.format,
+                             GL_UNSIGNED_BYTE, level.data);
+            }
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (!first.compressed) {
+        glGenerateMipmap(target);
+    }
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+void uploadTexture(unsigned int texture, const PreparedTexture &image) {
+    const GLenum imageTarget = GL_TEXTURE_2D;
+    const PreparedTexture *images[1] = {&image};
+    uploadImages(GL_TEXTURE_2D, texture, &imageTarget, images, 1);
+}
+
+void uploadCubemap(unsigned int texture,
+                   const PreparedTexture *const faces[6]) {
+    GLenum faceTargets[6];
+    for (int i = 0; i < 6; i++) {
+        faceTargets[i] = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
+    }
+    uploadImages(GL_TEXTURE_CUBE_MAP, texture, faceTargets, faces, 6);
+}
@@ -0,0 +1,56 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include "../include/glad/glad.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "virtual_file_system.hpp"
+
+// Niveau de mipmap d'une texture préparée
+struct TextureLevel {
+    const unsigned char *data;
+    size_t size; // En octets
+    int width, height;
+};
+
+// Texture lue et décodée sur le CPU, prête à être envoyée au GPU. La
+// préparation n'appelle pas OpenGL : elle peut se faire sur un thread de
+// travail (voir AssetLoader), l'envoi restant sur le thread GL.
+struct PreparedTexture {
+    int width, height; // Taille du niveau 0
+    bool compressed;   // Blocs BC1, sinon pixels non compressés
+    GLenum format;         // Format des pixels ou format compressé
+    GLenum internalFormat; // Format de stockage sur le GPU
+    // Compressée : toute la chaîne de mipmaps, jusqu'à 1 x 1. Sinon le seul
+    // niveau 0, les mipmaps étant générées par le GPU.
+    std::vector<TextureLevel> levels;
+
+    // Propriétaires des données désignées par levels
+    struct ImageDeleter {
+        void operator()(unsigned char *pixels) const;
+    };
+    FileData file;                     // Texture précalculée
+    std::vector<unsigned char> blocks; // Texture compressée à l'instant
+    std::unique_ptr<unsigned char, ImageDeleter> pixels; // Image décodée
+};
+
+// Préparer l'image path (JPEG, PNG...), lue à travers VirtualFileSystem.
+// Avec compressed, la texture est lue en blocs BC1 dans sa version
+// précalculée (chemin + TEXTURE_FILE_EXTENSION, voir texture_file.hpp),
+// recalculée et réécrite si l'image a changé ; sinon l'image est simplement
+// décodée. nullptr si elle ne peut être lue.
+std::shared_ptr<PreparedTexture> prepareTexture(const std::string &path,
+                                                bool compressed);
+
+// Envoyer une texture préparée dans la texture 2D texture, avec ses
+// mipmaps. À appeler sur le thread GL.
+void uploadTexture(unsigned int texture, const PreparedTexture &image);
+
+// Même chose pour les 6 faces de la cubemap texture (+X, -X, +Y, -Y, +Z,
+// -Z), qui doivent avoir la même taille et le même format
+void uploadCubemap(unsigned int texture, const PreparedTexture *const faces[6]);
+
+#endif
@@ -0,0 +1,83 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threadCount) : stopping(false) {
+    threadCount = std::max(threadCount, 1u);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    condition.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Arrêt demandé et plus rien à faire
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count,
+                             const std::function<void(size_t)> &body) {
+    if (count == 0) {
+        return;
+    }
+
+    // Les indices sont distribués un à un : un thread qui finit tôt reprend
+    // le travail restant
+    struct Progress {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto progress = std::make_shared<Progress>();
+    auto run = [progress, count, &body] {
+        size_t i;
+        while ((i = progress->next.fetch_add(1)) < count) {
+            body(i);
+            if (progress->done.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                progress->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(workers.size(), count - 1);
+    for (size_t i = 0; i < helpers; i++) {
+        submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(progress->mutex);
+    progress->finished.wait(lock, [&] { return progress->done == count; });
+}
@@ -0,0 +1,45 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Groupe de threads de travail réutilisable : les tâches soumises sont
+// exécutées dans l'ordre d'arrivée par le premier thread libre.
+class ThreadPool {
+  public:
+    // Par défaut, un thread par cœur (au moins un)
+    explicit ThreadPool(
+        unsigned int threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Ajouter une tâche à la file (retour immédiat)
+    void submit(std::function<void()> task);
+
+    // Appeler body(i) pour tout i de [0, count), réparti entre les threads
+    // et le thread appelant, et attendre la fin de tous les appels
+    void parallelFor(size_t count, const std::function<void(size_t)> &body);
+
+    unsigned int getThreadCount() const {
+        return static_cast<unsigned int>(workers.size());
+    }
+
+  private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef VERTEX_PACKING_H
+#define VERTEX_PACKING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Compression des attributs de sommet, décodée dans les vertex shaders
+// (voir octDecode dans shaders/car.vs et shaders/terrain.vs)
+
+// Normale unitaire projetée sur un octaèdre puis déplié dans le carré
+// [-1, 1]^2 : deux composantes de 16 bits, lues normalisées (GL_SHORT)
+inline void packOctahedralNormal(glm::vec3 normal, int16_t out[2]) {
+    const float sum =
+        std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    float u = 0.0f, v = 0.0f;
+    if (sum > 0.0f) {
+        u = normal.x / sum;
+        v = normal.y / sum;
+        if (normal.z < 0.0f) {
+            // Hémisphère inférieur replié sur les coins du carré
+            const float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            const float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = foldedU;
+            v = foldedV;
+        }
+    }
+    out[0] = static_cast<int16_t>(std::round(std::clamp(u, -1.0f, 1.0f) * 32767.0f));
+    out[1] = static_cast<int16_t>(std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+
+// Valeur de [offset, offset + 65535 * scale] ramenée sur 16 bits : le
+// shader la retrouve par q * scale + offset
+inline uint16_t quantizeUint16(float value, float offset, float scale) {
+    if (scale <= 0.0f) {
+        return 0;
+    }
+    return static_cast<uint16_t>(
+        std::clamp(std::round((value - offset) / scale), 0.0f, 65535.0f));
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "virtual_file_system.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#include "lz4_block.hpp"
+
+bool VirtualFileSystem::mount(const std::string &packPath) {
+    auto archive = std::make_unique<Archive>();
+    archive->path = packPath;
+    MappedFile &file = archive->file;
+    if (!file.open(packPath)) {
+        return false; // Pas d'archive : fichiers isolés seulement
+    }
+    auto corrupted = [&]() {
+        std::cerr << "Erreur : Archive tronquée ou corrompue : " << packPath
+                  << std::endl;
+        return false;
+    };
+    if (file.size() < sizeof(PackFileHeader)) {
+        return corrupted();
+    }
+
+    const PackFileHeader *header =
+        reinterpret_cast<const PackFileHeader *>(file.data());
+    if (!std::equal(header->magic, header->magic + 4, PACK_FILE_MAGIC) ||
+        header->version != PACK_FILE_VERSION) {
+        std::cerr << "Erreur : Format d'archive inconnu : " << packPath
+                  << std::endl;
+        return false;
+    }
+    auto validArray = [&](uint64_t offset, uint64_t bytes) {
+        return offset <= file.size() && bytes <= file.size() - offset;
+    };
+    const uint64_t entryBytes =
+        static_cast<uint64_t>(header->entryCount) * sizeof(PackEntry);
+    if (header->entryOffset % alignof(PackEntry) != 0 ||
+        !validArray(header->entryOffset, entryBytes) ||
+        header->nameOffset > file.size()) {
+        return corrupted();
+    }
+
+    // Chaque entrée doit désigner un chemin et un contenu dans l'archive
+    const PackEntry *entries =
+        reinterpret_cast<const PackEntry *>(file.data() + header->entryOffset);
+    const uint64_t nameBytes = file.size() - header->nameOffset;
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        const PackEntry &entry = entries[i];
+        const bool known =
+            entry.compression == static_cast<uint32_t>(PackCompression::NONE)
+                ? entry.storedSize == entry.size
+                : entry.compression ==
+                      static_cast<uint32_t>(PackCompression::LZ4);
+        if (!known || entry.nameOffset > nameBytes ||
+            entry.nameLength > nameBytes - entry.nameOffset ||
+            entry.offset % PACK_FILE_ALIGNMENT != 0 ||
+            !validArray(entry.offset, entry.storedSize)) {
+            return corrupted();
+        }
+        const char *name = reinterpret_cast<const char *>(
+            file.data() + header->nameOffset + entry.nameOffset);
+        archive->entries[std::string(name, entry.nameLength)] = &entry;
+    }
+
+    archives.push_back(std::move(archive));
+    return true;
+}
+
+const PackEntry *VirtualFileSystem::find(const std::string &path,
+                                         const Archive *&archive) const {
+    if (archives.empty()) {
+        return nullptr;
+    }
+    const std::string name = normalizePath(path);
+    for (auto it = archives.rbegin(); it != archives.rend(); ++it) {
+        auto entry = (*it)->entries.find(name);
+        if (entry != (*it)->entries.end()) {
+            archive = it->get();
+            return entry->second;
+        }
+    }
+    return nullptr;
+}
+
+bool VirtualFileSystem::read(const std::string &path, FileData &out) const {
+    out = FileData();
+    const Archive *archive = nullptr;
+    const PackEntry *entry = find(path, archive);
+    if (!entry) {
+        // Fichier isolé. Un fichier vide ne peut pas être projeté.
+        if (out.file.open(path)) {
+            out.view = out.file.data();
+            out.viewSize = out.file.size();
+            return true;
+        }
+        std::error_code error;
+        return std::filesystem::is_regular_file(path, error) &&
+               std::filesystem::file_size(path, error) == 0;
+    }
+
+    const unsigned char *stored = archive->file.data() + entry->offset;
+    if (entry->compression == static_cast<uint32_t>(PackCompression::NONE)) {
+        out.view = stored;
+        out.viewSize = entry->size;
+        return true;
+    }
+    out.buffer.resize(entry->size);
+    if (!decompressLz4(stored, entry->storedSize, out.buffer.data(),
+                       out.buffer.size())) {
+        std::cerr << "Erreur : Entrée d'archive corrompue : " << path << " ("
+                  << archive->path << ")" << std::endl;
+        out.buffer.clear();
+        return false;
+    }
+    out.view = out.buffer.data();
+    out.viewSize = out.buffer.size();
+    return true;
+}
+
+bool VirtualFileSystem::exists(const std::string &path) const {
+    const Archive *archive = nullptr;
+    if (find(path, archive)) {
+        return true;
+    }
+    std::error_code error;
+    return std::filesystem::is_regular_file(path, error);
+}
+
+std::string VirtualFileSystem::normalizePath(const std::string &path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+VirtualFileSystem &VirtualFileSystem::get() {
+    static VirtualFileSystem fileSystem;
+    return fileSystem;
+}
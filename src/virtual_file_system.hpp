@@ -0,0 +1,79 @@
+#ifndef VIRTUAL_FILE_SYSTEM_H
+#define VIRTUAL_FILE_SYSTEM_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "pack_file.hpp"
+
+// Contenu d'un fichier lu par VirtualFileSystem. Une entrée non compressée
+// d'une archive est lue directement dans ses pages projetées (l'archive
+// reste montée jusqu'à la fin du programme) ; une entrée compressée est
+// décompressée dans un tampon, un fichier isolé est projeté.
+class FileData {
+  public:
+    FileData() : view(nullptr), viewSize(0) {}
+
+    const unsigned char *data() const { return view; }
+    size_t size() const { return viewSize; }
+
+  private:
+    friend class VirtualFileSystem;
+    const unsigned char *view;
+    size_t viewSize;
+    std::vector<unsigned char> buffer; // Entrée décompressée
+    MappedFile file;                   // Fichier isolé
+};
+
+// Accès aux fichiers des assets (modèles, textures, shaders) : d'abord dans
+// les archives montées (voir pack_file.hpp), sinon sur le disque. Les
+// chemins sont relatifs au répertoire courant ("./models/a.obj" et
+// "models/a.obj" désignent le même fichier).
+class VirtualFileSystem {
+  public:
+    VirtualFileSystem() = default;
+    VirtualFileSystem(const VirtualFileSystem &) = delete;
+    VirtualFileSystem &operator=(const VirtualFileSystem &) = delete;
+
+    // Monter l'archive packPath : ses fichiers masquent les fichiers isolés
+    // de même chemin, et ceux des archives montées avant elle. false si
+    // l'archive manque ou est invalide. À faire avant les chargements : les
+    // lectures sont ensuite sûres depuis plusieurs threads.
+    bool mount(const std::string &packPath);
+
+    // Lire le fichier path dans out. false s'il n'existe pas (sans
+    // message) ou si son entrée est corrompue.
+    bool read(const std::string &path, FileData &out) const;
+
+    bool exists(const std::string &path) const;
+
+    // Nombre de fichiers de l'archive montée en dernier
+    size_t getMountedFileCount() const {
+        return archives.empty() ? 0 : archives.back()->entries.size();
+    }
+
+    // Système de fichiers partagé par les chargeurs d'assets
+    static VirtualFileSystem &get();
+
+    // Chemin sous la forme des entrées d'archive : "./models/../models/a.obj"
+    // devient "models/a.obj"
+    static std::string normalizePath(const std::string &path);
+
+  private:
+    struct Archive {
+        std::string path;
+        MappedFile file;
+        std::unordered_map<std::string, const PackEntry *> entries;
+    };
+    std::vector<std::unique_ptr<Archive>> archives;
+
+    // Entrée du fichier path dans la dernière archive qui le contient
+    const PackEntry *find(const std::string &path,
+                          const Archive *&archive) const;
+};
+
+#endif
@@ -0,0 +1,148 @@
+// Outil d'écriture des archives d'assets (voir src/pack_file.hpp).
+//
+//   pack_assets [--lz4] archive.pack chemin...
+//
+// Chaque chemin est un fichier ou un répertoire parcouru récursivement ;
+// les fichiers sont enregistrés sous leur chemin relatif au répertoire
+// courant, lu tel quel par le jeu. Avec --lz4, chaque contenu est compressé
+// en LZ4 quand il y gagne au moins PACK_LZ4_MIN_SAVING.
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/binary_writer.hpp"
+#include "../src/lz4_block.hpp"
+#include "../src/pack_file.hpp"
+
+// Part minimale de la taille gagnée pour garder un contenu compressé (les
+// JPEG, déjà compressés, restent bruts et se lisent sans copie)
+#define PACK_LZ4_MIN_SAVING 0.1
+
+namespace fs = std::filesystem;
+
+static bool readFile(const fs::path &path, std::vector<unsigned char> &out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(file),
+               std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool lz4 = false;
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+    if (!arguments.empty() && arguments[0] == "--lz4") {
+        lz4 = true;
+        arguments.erase(arguments.begin());
+    }
+    if (arguments.size() < 2) {
+        std::cerr << "Usage : pack_assets [--lz4] archive.pack chemin..."
+                  << std::endl;
+        return 1;
+    }
+    const fs::path packPath = arguments[0];
+
+    // Fichiers à archiver, triés par chemin
+    std::vector<std::string> names;
+    for (size_t i = 1; i < arguments.size(); i++) {
+        const fs::path root = arguments[i];
+        if (fs::is_regular_file(root)) {
+            names.push_back(root.lexically_normal().generic_string());
+            continue;
+        }
+        if (!fs::is_directory(root)) {
+            std::cerr << "Erreur : Chemin introuvable : " << root << std::endl;
+            return 1;
+        }
+        for (const fs::directory_entry &entry :
+             fs::recursive_directory_iterator(root)) {
+            if (entry.is_regular_file() &&
+                !fs::equivalent(entry.path(), packPath)) {
+                names.push_back(
+                    entry.path().lexically_normal().generic_string());
+            }
+        }
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    PackFileHeader header = {};
+    std::copy(PACK_FILE_MAGIC, PACK_FILE_MAGIC + 4, header.magic);
+    header.version = PACK_FILE_VERSION;
+    header.entryCount = static_cast<uint32_t>(names.size());
+    header.entryOffset = sizeof(PackFileHeader);
+    header.nameOffset =
+        header.entryOffset + names.size() * sizeof(PackEntry);
+
+    std::vector<PackEntry> entries(names.size());
+    std::string nameTable;
+    for (size_t i = 0; i < names.size(); i++) {
+        entries[i] = {};
+        entries[i].nameOffset = static_cast<uint32_t>(nameTable.size());
+        entries[i].nameLength = static_cast<uint32_t>(names[i].size());
+        nameTable += names[i];
+    }
+
+    std::ofstream pack(packPath, std::ios::binary | std::ios::trunc);
+    if (!pack) {
+        std::cerr << "Erreur : Impossible d'écrire l'archive : " << packPath
+                  << std::endl;
+        return 1;
+    }
+    // En-tête et table des entrées réécrits une fois les positions connues
+    pack.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    pack.write(reinterpret_cast<const char *>(entries.data()),
+               entries.size() * sizeof(PackEntry));
+    pack.write(nameTable.data(), nameTable.size());
+
+    uint64_t totalSize = 0, storedSize = 0;
+    std::vector<unsigned char> content, compressed;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!readFile(names[i], content)) {
+            std::cerr << "Erreur : Impossible de lire : " << names[i]
+                      << std::endl;
+            return 1;
+        }
+        const unsigned char *stored = content.data();
+        size_t size = content.size();
+        entries[i].compression = static_cast<uint32_t>(PackCompression::NONE);
+        if (lz4) {
+            compressLz4(content.data(), content.size(), compressed);
+            if (compressed.size() <
+                content.size() * (1.0 - PACK_LZ4_MIN_SAVING)) {
+                stored = compressed.data();
+                size = compressed.size();
+                entries[i].compression =
+                    static_cast<uint32_t>(PackCompression::LZ4);
+            }
+        }
+
+        const uint64_t offset = alignOffset(
+            static_cast<uint64_t>(pack.tellp()), PACK_FILE_ALIGNMENT);
+        writeAt(pack, offset, stored, size);
+        entries[i].offset = offset;
+        entries[i].storedSize = size;
+        entries[i].size = content.size();
+        totalSize += content.size();
+        storedSize += size;
+    }
+
+    pack.seekp(static_cast<std::streamoff>(header.entryOffset));
+    pack.write(reinterpret_cast<const char *>(entries.data()),
+               entries.size() * sizeof(PackEntry));
+    if (!pack) {
+        std::cerr << "Erreur : Écriture incomplète de l'archive : " << packPath
+                  << std::endl;
+        return 1;
+    }
+    std::cout << packPath.string() << " : " << names.size() << " fichiers, "
+              << totalSize << " octets -> " << storedSize << " octets"
+              << std::endl;
+    return 0;
+}